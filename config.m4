@@ -143,6 +143,7 @@ if test "$PHP_MONGODB" != "no"; then
     src/BSON/DBPointer.c \
     src/BSON/Decimal128.c \
     src/BSON/Decimal128Interface.c \
+    src/BSON/Hydratable.c \
     src/BSON/Int64.c \
     src/BSON/Javascript.c \
     src/BSON/JavascriptInterface.c \
@@ -154,6 +155,7 @@ if test "$PHP_MONGODB" != "no"; then
     src/BSON/ObjectIdInterface.c \
     src/BSON/PackedArray.c \
     src/BSON/Persistable.c \
+    src/BSON/Reader.c \
     src/BSON/Regex.c \
     src/BSON/RegexInterface.c \
     src/BSON/Serializable.c \
@@ -165,6 +167,7 @@ if test "$PHP_MONGODB" != "no"; then
     src/BSON/Unserializable.c \
     src/BSON/UTCDateTime.c \
     src/BSON/UTCDateTimeInterface.c \
+    src/BSON/Writer.c \
     src/BSON/functions.c \
     src/MongoDB/BulkWrite.c \
     src/MongoDB/ClientEncryption.c \
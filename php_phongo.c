@@ -25,6 +25,7 @@
 #include <ext/standard/info.h>
 
 #include "php_phongo.h"
+#include "src/phongo_bson.h"
 #include "src/phongo_client.h"
 #include "src/phongo_error.h"
 #include "src/phongo_ini.h"
@@ -120,6 +121,40 @@ PHP_RINIT_FUNCTION(mongodb) /* {{{ */
 		zend_hash_init(MONGODB_G(managers), 0, NULL, NULL, 0);
 	}
 
+	/* Initialize HashTable for parsed type maps, which is initialized to NULL
+	 * in GINIT and destroyed and reset to NULL in RSHUTDOWN. Type maps are
+	 * keyed by the address of their immutable array. Cached type maps may still
+	 * be referenced by objects freed after RSHUTDOWN, so the element destructor
+	 * only releases the cache's own reference. */
+	if (MONGODB_G(typemaps) == NULL) {
+		ALLOC_HASHTABLE(MONGODB_G(typemaps));
+		zend_hash_init(MONGODB_G(typemaps), 0, NULL, php_phongo_bson_typemap_cache_dtor, 0);
+	}
+
+	/* Initialize HashTable for document keys shared by decoded arrays, which
+	 * is initialized to NULL in GINIT and destroyed and reset to NULL in
+	 * RSHUTDOWN. Decoded values may outlive RSHUTDOWN, so the element
+	 * destructor only releases the cache's own reference to each key. */
+	if (MONGODB_G(bson_keys) == NULL) {
+		ALLOC_HASHTABLE(MONGODB_G(bson_keys));
+		zend_hash_init(MONGODB_G(bson_keys), 0, NULL, ZVAL_PTR_DTOR, 0);
+	}
+
+	/* Initialize HashTables for the encoding strategy of each class and the
+	 * Persistable classes named by decoded __pclass fields, which are
+	 * initialized to NULL in GINIT and destroyed and reset to NULL in
+	 * RSHUTDOWN. Both only store class entries, which remain valid for the
+	 * duration of the request. */
+	if (MONGODB_G(bson_classes) == NULL) {
+		ALLOC_HASHTABLE(MONGODB_G(bson_classes));
+		zend_hash_init(MONGODB_G(bson_classes), 0, NULL, NULL, 0);
+	}
+
+	if (MONGODB_G(odm_classes) == NULL) {
+		ALLOC_HASHTABLE(MONGODB_G(odm_classes));
+		zend_hash_init(MONGODB_G(odm_classes), 0, NULL, NULL, 0);
+	}
+
 	return SUCCESS;
 } /* }}} */
 
@@ -218,6 +253,7 @@ PHP_MINIT_FUNCTION(mongodb) /* {{{ */
 	php_phongo_type_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_serializable_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_unserializable_init_ce(INIT_FUNC_ARGS_PASSTHRU);
+	php_phongo_hydratable_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 
 	php_phongo_binary_interface_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_decimal128_interface_init_ce(INIT_FUNC_ARGS_PASSTHRU);
@@ -242,11 +278,13 @@ PHP_MINIT_FUNCTION(mongodb) /* {{{ */
 	php_phongo_minkey_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_objectid_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_persistable_init_ce(INIT_FUNC_ARGS_PASSTHRU);
+	php_phongo_reader_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_regex_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_symbol_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_timestamp_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_undefined_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 	php_phongo_utcdatetime_init_ce(INIT_FUNC_ARGS_PASSTHRU);
+	php_phongo_writer_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 
 	php_phongo_cursor_interface_init_ce(INIT_FUNC_ARGS_PASSTHRU);
 
@@ -357,6 +395,35 @@ PHP_RSHUTDOWN_FUNCTION(mongodb) /* {{{ */
 		MONGODB_G(managers) = NULL;
 	}
 
+	/* Destroy HashTable for parsed type maps, which was initialized in RINIT. */
+	if (MONGODB_G(typemaps)) {
+		zend_hash_destroy(MONGODB_G(typemaps));
+		FREE_HASHTABLE(MONGODB_G(typemaps));
+		MONGODB_G(typemaps) = NULL;
+	}
+
+	/* Destroy HashTable for decoded document keys, which was initialized in
+	 * RINIT. */
+	if (MONGODB_G(bson_keys)) {
+		zend_hash_destroy(MONGODB_G(bson_keys));
+		FREE_HASHTABLE(MONGODB_G(bson_keys));
+		MONGODB_G(bson_keys) = NULL;
+	}
+
+	/* Destroy HashTables for cached class lookups, which were initialized in
+	 * RINIT. */
+	if (MONGODB_G(bson_classes)) {
+		zend_hash_destroy(MONGODB_G(bson_classes));
+		FREE_HASHTABLE(MONGODB_G(bson_classes));
+		MONGODB_G(bson_classes) = NULL;
+	}
+
+	if (MONGODB_G(odm_classes)) {
+		zend_hash_destroy(MONGODB_G(odm_classes));
+		FREE_HASHTABLE(MONGODB_G(odm_classes));
+		MONGODB_G(odm_classes) = NULL;
+	}
+
 	return SUCCESS;
 } /* }}} */
 
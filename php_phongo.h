@@ -51,6 +51,10 @@ ZEND_BEGIN_MODULE_GLOBALS(mongodb)
 	HashTable* subscribers;
 	HashTable* managers;
 	HashTable* loggers;
+	HashTable* typemaps;
+	HashTable* bson_keys;
+	HashTable* bson_classes;
+	HashTable* odm_classes;
 ZEND_END_MODULE_GLOBALS(mongodb)
 
 #define MONGODB_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(mongodb, v)
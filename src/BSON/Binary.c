@@ -29,22 +29,26 @@
 zend_class_entry* php_phongo_binary_ce;
 
 /* Initialize the object and return whether it was successful. An exception will
- * be thrown on error. */
-static bool php_phongo_binary_init(php_phongo_binary_t* intern, const char* data, size_t data_len, zend_long type)
+ * be thrown on error. The data string is shared with the caller rather than
+ * copied, since zend_strings are immutable once they are referenced. */
+static bool php_phongo_binary_init(php_phongo_binary_t* intern, zend_string* data, zend_long type)
 {
 	if (type < 0 || type > UINT8_MAX) {
 		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected type to be an unsigned 8-bit integer, %" PHONGO_LONG_FORMAT " given", type);
 		return false;
 	}
 
-	if ((type == BSON_SUBTYPE_UUID_DEPRECATED || type == BSON_SUBTYPE_UUID) && data_len != PHONGO_BINARY_UUID_SIZE) {
-		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected UUID length to be %d bytes, %d given", PHONGO_BINARY_UUID_SIZE, data_len);
+	if ((type == BSON_SUBTYPE_UUID_DEPRECATED || type == BSON_SUBTYPE_UUID) && ZSTR_LEN(data) != PHONGO_BINARY_UUID_SIZE) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected UUID length to be %d bytes, %d given", PHONGO_BINARY_UUID_SIZE, (int) ZSTR_LEN(data));
 		return false;
 	}
 
-	intern->data     = estrndup(data, data_len);
-	intern->data_len = data_len;
-	intern->type     = (uint8_t) type;
+	if (intern->data) {
+		zend_string_release(intern->data);
+	}
+
+	intern->data = zend_string_copy(data);
+	intern->type = (uint8_t) type;
 
 	return true;
 }
@@ -58,7 +62,7 @@ static bool php_phongo_binary_init_from_hash(php_phongo_binary_t* intern, HashTa
 	if ((data = zend_hash_str_find(props, "data", sizeof("data") - 1)) && Z_TYPE_P(data) == IS_STRING &&
 		(type = zend_hash_str_find(props, "type", sizeof("type") - 1)) && Z_TYPE_P(type) == IS_LONG) {
 
-		return php_phongo_binary_init(intern, Z_STRVAL_P(data), Z_STRLEN_P(data), Z_LVAL_P(type));
+		return php_phongo_binary_init(intern, Z_STR_P(data), Z_LVAL_P(type));
 	}
 
 	phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "%s initialization requires \"data\" string and \"type\" integer fields", ZSTR_VAL(php_phongo_binary_ce->name));
@@ -81,7 +85,7 @@ static HashTable* php_phongo_binary_get_properties_hash(zend_object* object, boo
 	{
 		zval data, type;
 
-		ZVAL_STRINGL(&data, intern->data, intern->data_len);
+		ZVAL_STR_COPY(&data, intern->data);
 		zend_hash_str_update(props, "data", sizeof("data") - 1, &data);
 
 		ZVAL_LONG(&type, intern->type);
@@ -95,19 +99,18 @@ static HashTable* php_phongo_binary_get_properties_hash(zend_object* object, boo
 static PHP_METHOD(MongoDB_BSON_Binary, __construct)
 {
 	php_phongo_binary_t* intern;
-	char*                data;
-	size_t               data_len;
+	zend_string*         data;
 	zend_long            type = BSON_SUBTYPE_BINARY;
 
 	intern = Z_BINARY_OBJ_P(getThis());
 
 	PHONGO_PARSE_PARAMETERS_START(1, 2)
-	Z_PARAM_STRING(data, data_len)
+	Z_PARAM_STR(data)
 	Z_PARAM_OPTIONAL
 	Z_PARAM_LONG(type)
 	PHONGO_PARSE_PARAMETERS_END();
 
-	php_phongo_binary_init(intern, data, data_len, type);
+	php_phongo_binary_init(intern, data, type);
 }
 
 static PHP_METHOD(MongoDB_BSON_Binary, __set_state)
@@ -137,7 +140,7 @@ static PHP_METHOD(MongoDB_BSON_Binary, __toString)
 
 	intern = Z_BINARY_OBJ_P(getThis());
 
-	RETURN_STRINGL(intern->data, intern->data_len);
+	RETURN_STR_COPY(intern->data);
 }
 
 static PHP_METHOD(MongoDB_BSON_Binary, getData)
@@ -148,7 +151,7 @@ static PHP_METHOD(MongoDB_BSON_Binary, getData)
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	RETURN_STRINGL(intern->data, intern->data_len);
+	RETURN_STR_COPY(intern->data);
 }
 
 static PHP_METHOD(MongoDB_BSON_Binary, getType)
@@ -175,7 +178,7 @@ static PHP_METHOD(MongoDB_BSON_Binary, jsonSerialize)
 	array_init_size(return_value, 2);
 
 	{
-		zend_string* data = php_base64_encode((unsigned char*) intern->data, intern->data_len);
+		zend_string* data = php_base64_encode((unsigned char*) ZSTR_VAL(intern->data), ZSTR_LEN(intern->data));
 		ADD_ASSOC_STRINGL(return_value, "$binary", ZSTR_VAL(data), ZSTR_LEN(data));
 		zend_string_free(data);
 	}
@@ -196,7 +199,7 @@ static PHP_METHOD(MongoDB_BSON_Binary, serialize)
 	PHONGO_PARSE_PARAMETERS_NONE();
 
 	array_init_size(&retval, 2);
-	ADD_ASSOC_STRINGL(&retval, "data", intern->data, intern->data_len);
+	add_assoc_str_ex(&retval, "data", sizeof("data") - 1, zend_string_copy(intern->data));
 	ADD_ASSOC_LONG_EX(&retval, "type", intern->type);
 
 	PHP_VAR_SERIALIZE_INIT(var_hash);
@@ -266,7 +269,7 @@ static void php_phongo_binary_free_object(zend_object* object)
 	zend_object_std_dtor(&intern->std);
 
 	if (intern->data) {
-		efree(intern->data);
+		zend_string_release(intern->data);
 	}
 
 	if (intern->properties) {
@@ -299,7 +302,8 @@ static zend_object* php_phongo_binary_clone_object(zend_object* object)
 	new_intern = Z_OBJ_BINARY(new_object);
 	zend_objects_clone_members(&new_intern->std, &intern->std);
 
-	php_phongo_binary_init(new_intern, intern->data, intern->data_len, intern->type);
+	/* The clone shares the original's data string */
+	php_phongo_binary_init(new_intern, intern->data, intern->type);
 
 	return new_object;
 }
@@ -315,15 +319,15 @@ static int php_phongo_binary_compare_objects(zval* o1, zval* o2)
 
 	/* MongoDB compares binary types first by the data length, then by the type
 	 * byte, and finally by the binary data itself. */
-	if (intern1->data_len != intern2->data_len) {
-		return intern1->data_len < intern2->data_len ? -1 : 1;
+	if (ZSTR_LEN(intern1->data) != ZSTR_LEN(intern2->data)) {
+		return ZSTR_LEN(intern1->data) < ZSTR_LEN(intern2->data) ? -1 : 1;
 	}
 
 	if (intern1->type != intern2->type) {
 		return intern1->type < intern2->type ? -1 : 1;
 	}
 
-	return zend_binary_strcmp(intern1->data, intern1->data_len, intern2->data, intern2->data_len);
+	return zend_binary_strcmp(ZSTR_VAL(intern1->data), ZSTR_LEN(intern1->data), ZSTR_VAL(intern2->data), ZSTR_LEN(intern2->data));
 }
 
 static HashTable* php_phongo_binary_get_debug_info(zend_object* object, int* is_temp)
@@ -357,10 +361,9 @@ bool phongo_binary_new(zval* object, const char* data, size_t data_len, bson_sub
 
 	object_init_ex(object, php_phongo_binary_ce);
 
-	intern           = Z_BINARY_OBJ_P(object);
-	intern->data     = estrndup(data, data_len);
-	intern->data_len = data_len;
-	intern->type     = (uint8_t) type;
+	intern       = Z_BINARY_OBJ_P(object);
+	intern->data = zend_string_init(data, data_len, 0);
+	intern->type = (uint8_t) type;
 
 	return true;
 }
@@ -168,6 +168,60 @@ static PHP_METHOD(MongoDB_BSON_Document, fromPHP)
 	RETURN_ZVAL(&zv, 1, 1);
 }
 
+/* Builds the key index for the document. Only the first occurrence of a
+ * duplicate key is indexed, which is consistent with bson_iter_find(). */
+static php_phongo_document_index_t* php_phongo_document_get_index(php_phongo_document_t* intern)
+{
+	php_phongo_document_index_t* index;
+	bson_iter_t                  iter;
+
+	if (intern->index) {
+		return intern->index;
+	}
+
+	index            = emalloc(sizeof(php_phongo_document_index_t));
+	index->ref_count = 1;
+	zend_hash_init(&index->offsets, 8, NULL, NULL, 0);
+
+	if (bson_iter_init(&iter, intern->bson)) {
+		while (bson_iter_next(&iter)) {
+			zval offset;
+
+			ZVAL_LONG(&offset, bson_iter_offset(&iter));
+			zend_hash_str_add(&index->offsets, bson_iter_key(&iter), bson_iter_key_len(&iter), &offset);
+		}
+	}
+
+	intern->index = index;
+
+	return index;
+}
+
+static void php_phongo_document_index_release(php_phongo_document_index_t* index)
+{
+	if (--index->ref_count > 0) {
+		return;
+	}
+
+	zend_hash_destroy(&index->offsets);
+	efree(index);
+}
+
+/* Positions the iterator on the element with the given key using the key
+ * index, which is built on the first lookup. Returns false if the key does not
+ * exist in the document. */
+static bool php_phongo_document_find(php_phongo_document_t* intern, const char* key, size_t key_len, bson_iter_t* iter)
+{
+	php_phongo_document_index_t* index = php_phongo_document_get_index(intern);
+	zval*                        offset;
+
+	if (!(offset = zend_hash_str_find(&index->offsets, key, key_len))) {
+		return false;
+	}
+
+	return bson_iter_init_from_data_at_offset(iter, bson_get_data(intern->bson), intern->bson->len, (uint32_t) Z_LVAL_P(offset), (uint32_t) key_len);
+}
+
 static bool php_phongo_document_get(php_phongo_document_t* intern, char* key, size_t key_len, zval* return_value, bool null_if_missing)
 {
 	bson_iter_t iter;
@@ -177,7 +231,7 @@ static bool php_phongo_document_get(php_phongo_document_t* intern, char* key, si
 		return false;
 	}
 
-	if (!bson_iter_find_w_len(&iter, key, key_len)) {
+	if (!php_phongo_document_find(intern, key, key_len, &iter)) {
 		if (null_if_missing) {
 			ZVAL_NULL(return_value);
 			return true;
@@ -210,10 +264,129 @@ static PHP_METHOD(MongoDB_BSON_Document, get)
 	}
 }
 
+/* Advances the iterator to the element with the given key. Unlike
+ * bson_iter_find_w_len(), this compares the full key length so that keys
+ * containing null bytes never match. */
+static bool php_phongo_document_iter_find(bson_iter_t* iter, const char* key, size_t key_len)
+{
+	while (bson_iter_next(iter)) {
+		if (bson_iter_key_len(iter) == key_len && memcmp(bson_iter_key(iter), key, key_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Positions the iterator on the element at the given dot-separated path. The
+ * first segment uses the key index and each further level is traversed in
+ * place with bson_iter_recurse(), so no intermediate documents or arrays are
+ * copied. Array elements are addressed by their index. */
+static bool php_phongo_document_find_path(php_phongo_document_t* intern, const char* path, size_t path_len, bson_iter_t* iter)
+{
+	const char* end     = path + path_len;
+	const char* segment = path;
+	const char* dot     = memchr(segment, '.', path_len);
+
+	if (!php_phongo_document_find(intern, segment, dot ? (size_t) (dot - segment) : path_len, iter)) {
+		return false;
+	}
+
+	while (dot) {
+		bson_iter_t child;
+
+		segment = dot + 1;
+		dot     = memchr(segment, '.', end - segment);
+
+		if (!BSON_ITER_HOLDS_DOCUMENT(iter) && !BSON_ITER_HOLDS_ARRAY(iter)) {
+			return false;
+		}
+
+		if (!bson_iter_recurse(iter, &child) || !php_phongo_document_iter_find(&child, segment, dot ? (size_t) (dot - segment) : (size_t) (end - segment))) {
+			return false;
+		}
+
+		memcpy(iter, &child, sizeof(bson_iter_t));
+	}
+
+	return true;
+}
+
+static PHP_METHOD(MongoDB_BSON_Document, getPath)
+{
+	php_phongo_document_t* intern;
+	char*                  path;
+	size_t                 path_len;
+	bson_iter_t            iter;
+
+	PHONGO_PARSE_PARAMETERS_START(1, 1)
+	Z_PARAM_STRING(path, path_len)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	intern = Z_DOCUMENT_OBJ_P(getThis());
+
+	if (!php_phongo_document_find_path(intern, path, path_len, &iter)) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not find path \"%s\" in BSON document", path);
+		return;
+	}
+
+	if (!phongo_bson_value_to_zval(bson_iter_value(&iter), return_value)) {
+		/* Exception already thrown */
+		return;
+	}
+}
+
+static PHP_METHOD(MongoDB_BSON_Document, extract)
+{
+	php_phongo_document_t* intern;
+	HashTable*             paths;
+	zval*                  path;
+
+	PHONGO_PARSE_PARAMETERS_START(1, 1)
+	Z_PARAM_ARRAY_HT(paths)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	intern = Z_DOCUMENT_OBJ_P(getThis());
+
+	array_init_size(return_value, zend_hash_num_elements(paths));
+
+	ZEND_HASH_FOREACH_VAL_IND(paths, path)
+	{
+		bson_iter_t iter;
+		zval        value;
+
+		ZVAL_DEREF(path);
+
+		if (Z_TYPE_P(path) != IS_STRING) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected path to be a string, %s given", zend_zval_type_name(path));
+			zval_ptr_dtor(return_value);
+			RETURN_NULL();
+		}
+
+		/* Paths that do not exist are omitted from the result */
+		if (!php_phongo_document_find_path(intern, Z_STRVAL_P(path), Z_STRLEN_P(path), &iter)) {
+			continue;
+		}
+
+		if (!phongo_bson_value_to_zval(bson_iter_value(&iter), &value)) {
+			/* Exception already thrown */
+			zval_ptr_dtor(return_value);
+			RETURN_NULL();
+		}
+
+		zend_symtable_update(Z_ARRVAL_P(return_value), Z_STR_P(path), &value);
+	}
+	ZEND_HASH_FOREACH_END();
+}
+
 static PHP_METHOD(MongoDB_BSON_Document, getIterator)
 {
 	PHONGO_PARSE_PARAMETERS_NONE();
 
+	/* The iterator retains pointers into the BSON data, so a borrowed document
+	 * must own its data before it can be iterated. */
+	phongo_document_detach(getThis());
+
 	phongo_iterator_init(return_value, getThis());
 }
 
@@ -226,7 +399,7 @@ static bool php_phongo_document_has(php_phongo_document_t* intern, char* key, si
 		return false;
 	}
 
-	return bson_iter_find_w_len(&iter, key, key_len);
+	return php_phongo_document_find(intern, key, key_len, &iter);
 }
 
 static PHP_METHOD(MongoDB_BSON_Document, has)
@@ -452,14 +625,35 @@ static PHP_METHOD(MongoDB_BSON_Document, __unserialize)
 /* MongoDB\BSON\BSON object handlers */
 static zend_object_handlers php_phongo_handler_document;
 
+/* Frees the bson_t of a Document. A borrowed bson_t was initialized with
+ * bson_init_static() and does not own its data, so only the struct itself is
+ * freed. */
+static void php_phongo_document_release_bson(php_phongo_document_t* intern)
+{
+	if (!intern->bson) {
+		return;
+	}
+
+	if (intern->borrowed) {
+		bson_free(intern->bson);
+	} else {
+		bson_destroy(intern->bson);
+	}
+
+	intern->bson     = NULL;
+	intern->borrowed = false;
+}
+
 static void php_phongo_document_free_object(zend_object* object)
 {
 	php_phongo_document_t* intern = Z_OBJ_DOCUMENT(object);
 
 	zend_object_std_dtor(&intern->std);
 
-	if (intern->bson) {
-		bson_destroy(intern->bson);
+	php_phongo_document_release_bson(intern);
+
+	if (intern->index) {
+		php_phongo_document_index_release(intern->index);
 	}
 
 	if (intern->properties) {
@@ -494,6 +688,12 @@ static zend_object* php_phongo_document_clone_object(zend_object* object)
 
 	new_intern->bson = bson_copy(intern->bson);
 
+	/* The clone has identical data, so the key index can be shared */
+	if (intern->index) {
+		new_intern->index = intern->index;
+		new_intern->index->ref_count++;
+	}
+
 	return new_object;
 }
 
@@ -666,3 +866,47 @@ bool phongo_document_new(zval* object, bson_t* bson, bool copy)
 
 	return true;
 }
+
+/* Initializes a Document that references BSON data owned elsewhere (e.g. the
+ * current result of a cursor) instead of copying it. The owner must call
+ * phongo_document_detach() before that data is invalidated if the Document may
+ * still be referenced. On error, an exception will have been thrown and false
+ * will be returned. */
+bool phongo_document_new_borrowed(zval* object, const bson_t* bson)
+{
+	php_phongo_document_t* intern;
+
+	object_init_ex(object, php_phongo_document_ce);
+
+	intern           = Z_DOCUMENT_OBJ_P(object);
+	intern->bson     = bson_malloc(sizeof(bson_t));
+	intern->borrowed = true;
+
+	/* The static bson_t references the data without taking ownership of it */
+	if (!bson_init_static(intern->bson, bson_get_data(bson), bson->len)) {
+		zval_ptr_dtor(object);
+		ZVAL_UNDEF(object);
+
+		phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Could not initialize %s from BSON data", ZSTR_VAL(php_phongo_document_ce->name));
+		return false;
+	}
+
+	return true;
+}
+
+/* Copies the data of a borrowed Document so that it no longer references its
+ * original owner. This is a no-op if the Document already owns its data. */
+void phongo_document_detach(zval* object)
+{
+	php_phongo_document_t* intern = Z_DOCUMENT_OBJ_P(object);
+	bson_t*                copy;
+
+	if (!intern->borrowed) {
+		return;
+	}
+
+	copy = bson_copy(intern->bson);
+	php_phongo_document_release_bson(intern);
+
+	intern->bson = copy;
+}
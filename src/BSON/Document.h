@@ -18,5 +18,7 @@
 #define PHONGO_BSON_DOCUMENT_H
 
 bool phongo_document_new(zval* object, bson_t* bson, bool copy);
+bool phongo_document_new_borrowed(zval* object, const bson_t* bson);
+void phongo_document_detach(zval* object);
 
 #endif /* PHONGO_BSON_DOCUMENT_H */
@@ -19,6 +19,10 @@ final class Document implements \IteratorAggregate, \Serializable, \ArrayAccess,
 
     final public function get(string $key): mixed {}
 
+    final public function getPath(string $path): mixed {}
+
+    final public function extract(array $paths): array {}
+
     final public function getIterator(): Iterator {}
 
     final public function has(string $key): bool {}
@@ -0,0 +1,12 @@
+<?php
+
+/**
+ * @generate-class-entries static
+ * @generate-function-entries
+ */
+
+namespace MongoDB\BSON;
+
+interface Hydratable
+{
+}
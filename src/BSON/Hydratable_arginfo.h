@@ -0,0 +1,19 @@
+/* This is a generated file, edit the .stub.php file instead.
+ * Stub hash: 477a45a42c00c8a99ef5afb2b7b7cd0745bc2950 */
+
+
+
+
+static const zend_function_entry class_MongoDB_BSON_Hydratable_methods[] = {
+	ZEND_FE_END
+};
+
+static zend_class_entry *register_class_MongoDB_BSON_Hydratable(void)
+{
+	zend_class_entry ce, *class_entry;
+
+	INIT_NS_CLASS_ENTRY(ce, "MongoDB\\BSON", "Hydratable", class_MongoDB_BSON_Hydratable_methods);
+	class_entry = zend_register_internal_interface(&ce);
+
+	return class_entry;
+}
@@ -25,8 +25,8 @@
 #include "phongo_error.h"
 #include "ObjectId_arginfo.h"
 
-#define PHONGO_OID_SIZE sizeof(((php_phongo_objectid_t*) 0)->oid)
-#define PHONGO_OID_LEN (PHONGO_OID_SIZE - 1)
+/* Length of the hex string representation, excluding the null terminator */
+#define PHONGO_OID_LEN 24
 
 zend_class_entry* php_phongo_objectid_ce;
 
@@ -34,12 +34,9 @@ zend_class_entry* php_phongo_objectid_ce;
  * successful. */
 static bool php_phongo_objectid_init(php_phongo_objectid_t* intern)
 {
-	bson_oid_t oid;
-
 	intern->initialized = true;
 
-	bson_oid_init(&oid, NULL);
-	bson_oid_to_string(&oid, intern->oid);
+	bson_oid_init(&intern->oid, NULL);
 
 	return true;
 }
@@ -49,10 +46,7 @@ static bool php_phongo_objectid_init(php_phongo_objectid_t* intern)
 static bool php_phongo_objectid_init_from_hex_string(php_phongo_objectid_t* intern, const char* hex, size_t hex_len)
 {
 	if (bson_oid_is_valid(hex, hex_len)) {
-		bson_oid_t oid;
-
-		bson_oid_init_from_string(&oid, hex);
-		bson_oid_to_string(&oid, intern->oid);
+		bson_oid_init_from_string(&intern->oid, hex);
 		intern->initialized = true;
 
 		return true;
@@ -79,6 +73,17 @@ static bool php_phongo_objectid_init_from_hash(php_phongo_objectid_t* intern, Ha
 	return false;
 }
 
+/* Returns the hex string representation of the ObjectId. The string is only
+ * formatted on demand, since the object stores the raw bytes. */
+static zend_string* php_phongo_objectid_to_hex_string(php_phongo_objectid_t* intern)
+{
+	zend_string* hex = zend_string_alloc(PHONGO_OID_LEN, 0);
+
+	bson_oid_to_string(&intern->oid, ZSTR_VAL(hex));
+
+	return hex;
+}
+
 static HashTable* php_phongo_objectid_get_properties_hash(zend_object* object, bool is_temp)
 {
 	php_phongo_objectid_t* intern;
@@ -95,7 +100,7 @@ static HashTable* php_phongo_objectid_get_properties_hash(zend_object* object, b
 	{
 		zval zv;
 
-		ZVAL_STRING(&zv, intern->oid);
+		ZVAL_STR(&zv, php_phongo_objectid_to_hex_string(intern));
 		zend_hash_str_update(props, "oid", sizeof("oid") - 1, &zv);
 	}
 
@@ -126,14 +131,12 @@ static PHP_METHOD(MongoDB_BSON_ObjectId, __construct)
 static PHP_METHOD(MongoDB_BSON_ObjectId, getTimestamp)
 {
 	php_phongo_objectid_t* intern;
-	bson_oid_t             tmp_oid;
 
 	intern = Z_OBJECTID_OBJ_P(getThis());
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	bson_oid_init_from_string(&tmp_oid, intern->oid);
-	RETVAL_LONG(bson_oid_get_time_t(&tmp_oid));
+	RETVAL_LONG(bson_oid_get_time_t(&intern->oid));
 }
 
 static PHP_METHOD(MongoDB_BSON_ObjectId, __set_state)
@@ -162,7 +165,7 @@ static PHP_METHOD(MongoDB_BSON_ObjectId, __toString)
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	RETURN_STRINGL(intern->oid, PHONGO_OID_LEN);
+	RETURN_STR(php_phongo_objectid_to_hex_string(intern));
 }
 
 static PHP_METHOD(MongoDB_BSON_ObjectId, jsonSerialize)
@@ -174,7 +177,7 @@ static PHP_METHOD(MongoDB_BSON_ObjectId, jsonSerialize)
 	intern = Z_OBJECTID_OBJ_P(getThis());
 
 	array_init_size(return_value, 1);
-	ADD_ASSOC_STRINGL(return_value, "$oid", intern->oid, PHONGO_OID_LEN);
+	add_assoc_str_ex(return_value, "$oid", sizeof("$oid") - 1, php_phongo_objectid_to_hex_string(intern));
 }
 
 static PHP_METHOD(MongoDB_BSON_ObjectId, serialize)
@@ -189,7 +192,7 @@ static PHP_METHOD(MongoDB_BSON_ObjectId, serialize)
 	PHONGO_PARSE_PARAMETERS_NONE();
 
 	array_init_size(&retval, 1);
-	ADD_ASSOC_STRINGL(&retval, "oid", intern->oid, PHONGO_OID_LEN);
+	add_assoc_str_ex(&retval, "oid", sizeof("oid") - 1, php_phongo_objectid_to_hex_string(intern));
 
 	PHP_VAR_SERIALIZE_INIT(var_hash);
 	php_var_serialize(&buf, &retval, &var_hash);
@@ -287,8 +290,7 @@ static zend_object* php_phongo_objectid_clone_object(zend_object* object)
 	new_intern = Z_OBJ_OBJECTID(new_object);
 	zend_objects_clone_members(&new_intern->std, &intern->std);
 
-	// Use memcpy to copy bson value to avoid converting to string and back
-	memcpy(&new_intern->oid, &intern->oid, PHONGO_OID_SIZE);
+	bson_oid_copy(&intern->oid, &new_intern->oid);
 	new_intern->initialized = true;
 
 	return new_object;
@@ -304,7 +306,8 @@ static int php_phongo_objectid_compare_objects(zval* o1, zval* o2)
 	intern1 = Z_OBJECTID_OBJ_P(o1);
 	intern2 = Z_OBJECTID_OBJ_P(o2);
 
-	return strcmp(intern1->oid, intern2->oid);
+	/* Comparing the raw bytes orders ObjectIds the same as their hex strings */
+	return ZEND_NORMALIZE_BOOL(bson_oid_compare(&intern1->oid, &intern2->oid));
 }
 
 static HashTable* php_phongo_objectid_get_debug_info(zend_object* object, int* is_temp)
@@ -339,7 +342,7 @@ bool phongo_objectid_new(zval* return_value, const bson_oid_t* oid)
 	object_init_ex(return_value, php_phongo_objectid_ce);
 
 	intern = Z_OBJECTID_OBJ_P(return_value);
-	bson_oid_to_string(oid, intern->oid);
+	bson_oid_copy(oid, &intern->oid);
 	intern->initialized = true;
 
 	return true;
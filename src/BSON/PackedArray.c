@@ -184,15 +184,66 @@ static PHP_METHOD(MongoDB_BSON_PackedArray, fromPHP)
 	RETURN_ZVAL(&zv, 1, 1);
 }
 
-static bool seek_iter_to_index(bson_iter_t* iter, zend_long index)
+/* Builds the offset table for the array on first use. Elements are indexed by
+ * position regardless of their keys, and iteration stops at the first invalid
+ * element. */
+static php_phongo_packedarray_index_t* php_phongo_packedarray_get_index(php_phongo_packedarray_t* intern)
 {
-	for (zend_long i = 0; i <= index; i++) {
-		if (!bson_iter_next(iter)) {
-			return false;
+	php_phongo_packedarray_index_t* index;
+	bson_iter_t                     iter;
+	uint32_t                        size = 8;
+
+	if (intern->index) {
+		return intern->index;
+	}
+
+	index            = emalloc(sizeof(php_phongo_packedarray_index_t));
+	index->offsets   = safe_emalloc(size, sizeof(uint32_t), 0);
+	index->count     = 0;
+	index->ref_count = 1;
+
+	if (bson_iter_init(&iter, intern->bson)) {
+		while (bson_iter_next(&iter)) {
+			if (index->count == size) {
+				size *= 2;
+				index->offsets = safe_erealloc(index->offsets, size, sizeof(uint32_t), 0);
+			}
+
+			index->offsets[index->count++] = bson_iter_offset(&iter);
 		}
 	}
 
-	return true;
+	intern->index = index;
+
+	return index;
+}
+
+static void php_phongo_packedarray_index_release(php_phongo_packedarray_index_t* index)
+{
+	if (--index->ref_count > 0) {
+		return;
+	}
+
+	efree(index->offsets);
+	efree(index);
+}
+
+static bool seek_iter_to_index(php_phongo_packedarray_t* intern, bson_iter_t* iter, zend_long index)
+{
+	php_phongo_packedarray_index_t* table = php_phongo_packedarray_get_index(intern);
+	const uint8_t*                  data;
+	uint32_t                        offset;
+
+	if (index < 0 || index >= table->count) {
+		return false;
+	}
+
+	data   = bson_get_data(intern->bson);
+	offset = table->offsets[index];
+
+	/* The key directly follows the type byte and was validated when the index
+	 * was built, so it is known to be null-terminated. */
+	return bson_iter_init_from_data_at_offset(iter, data, intern->bson->len, offset, (uint32_t) strlen((const char*) data + offset + 1));
 }
 
 static bool php_phongo_packedarray_get(php_phongo_packedarray_t* intern, zend_long index, zval* return_value, bool null_if_missing)
@@ -204,7 +255,7 @@ static bool php_phongo_packedarray_get(php_phongo_packedarray_t* intern, zend_lo
 		return false;
 	}
 
-	if (!seek_iter_to_index(&iter, index)) {
+	if (!seek_iter_to_index(intern, &iter, index)) {
 		if (null_if_missing) {
 			ZVAL_NULL(return_value);
 			return true;
@@ -219,6 +270,17 @@ static bool php_phongo_packedarray_get(php_phongo_packedarray_t* intern, zend_lo
 	return true;
 }
 
+static PHP_METHOD(MongoDB_BSON_PackedArray, count)
+{
+	php_phongo_packedarray_t* intern;
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	intern = Z_PACKEDARRAY_OBJ_P(getThis());
+
+	RETURN_LONG(php_phongo_packedarray_get_index(intern)->count);
+}
+
 static PHP_METHOD(MongoDB_BSON_PackedArray, get)
 {
 	php_phongo_packedarray_t* intern;
@@ -252,7 +314,7 @@ static bool php_phongo_packedarray_has(php_phongo_packedarray_t* intern, zend_lo
 		return false;
 	}
 
-	return seek_iter_to_index(&iter, index);
+	return seek_iter_to_index(intern, &iter, index);
 }
 
 static PHP_METHOD(MongoDB_BSON_PackedArray, has)
@@ -488,6 +550,10 @@ static void php_phongo_packedarray_free_object(zend_object* object)
 		bson_destroy(intern->bson);
 	}
 
+	if (intern->index) {
+		php_phongo_packedarray_index_release(intern->index);
+	}
+
 	if (intern->properties) {
 		zend_hash_destroy(intern->properties);
 		FREE_HASHTABLE(intern->properties);
@@ -520,6 +586,12 @@ static zend_object* php_phongo_packedarray_clone_object(zend_object* object)
 
 	new_intern->bson = bson_copy(intern->bson);
 
+	/* The clone has identical data, so the offset table can be shared */
+	if (intern->index) {
+		new_intern->index = intern->index;
+		new_intern->index->ref_count++;
+	}
+
 	return new_object;
 }
 
@@ -624,7 +696,7 @@ void php_phongo_packedarray_unset_dimension(zend_object* object, zval* offset)
 
 void php_phongo_packedarray_init_ce(INIT_FUNC_ARGS)
 {
-	php_phongo_packedarray_ce                = register_class_MongoDB_BSON_PackedArray(zend_ce_aggregate, zend_ce_serializable, zend_ce_arrayaccess, php_phongo_type_ce, zend_ce_stringable);
+	php_phongo_packedarray_ce                = register_class_MongoDB_BSON_PackedArray(zend_ce_aggregate, zend_ce_serializable, zend_ce_arrayaccess, php_phongo_type_ce, zend_ce_stringable, zend_ce_countable);
 	php_phongo_packedarray_ce->create_object = php_phongo_packedarray_create_object;
 
 	memcpy(&php_phongo_handler_packedarray, phongo_get_std_object_handlers(), sizeof(zend_object_handlers));
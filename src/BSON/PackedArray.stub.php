@@ -7,7 +7,7 @@
 
 namespace MongoDB\BSON;
 
-final class PackedArray implements \IteratorAggregate, \Serializable, \ArrayAccess, Type, \Stringable
+final class PackedArray implements \IteratorAggregate, \Serializable, \ArrayAccess, Type, \Stringable, \Countable
 {
     private function __construct() {}
 
@@ -15,6 +15,8 @@ final class PackedArray implements \IteratorAggregate, \Serializable, \ArrayAcce
 
     final static public function fromPHP(array $value): PackedArray {}
 
+    final public function count(): int {}
+
     final public function get(int $index): mixed {}
 
     final public function getIterator(): Iterator {}
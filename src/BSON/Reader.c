@@ -0,0 +1,273 @@
+/*
+ * Copyright 2024-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <php.h>
+#include <Zend/zend_interfaces.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php_phongo.h"
+#include "phongo_bson.h"
+#include "phongo_error.h"
+
+#include "BSON/Document.h"
+#include "BSON/Reader_arginfo.h"
+
+zend_class_entry* php_phongo_reader_ce;
+
+/* Read callback for bson_reader_t. The stream is fetched from its resource on
+ * each call so that a stream closed by the application is reported as a read
+ * error instead of being accessed after it was freed. */
+static ssize_t php_phongo_reader_read_stream(void* handle, void* buf, size_t count)
+{
+	php_phongo_reader_t* intern = (php_phongo_reader_t*) handle;
+	php_stream*          stream;
+	ssize_t              read;
+
+	stream = (php_stream*) zend_fetch_resource2(Z_RES(intern->stream), NULL, php_file_le_stream(), php_file_le_pstream());
+	if (!stream) {
+		return -1;
+	}
+
+	read = php_stream_read(stream, buf, count);
+	if (read > 0) {
+		intern->bytes_read += read;
+	}
+
+	return read;
+}
+
+static void php_phongo_reader_free_current(php_phongo_reader_t* intern)
+{
+	if (Z_ISUNDEF(intern->visitor_data.zchild)) {
+		return;
+	}
+
+	/* A Document created for the "bson" root type references the reader's
+	 * buffer, which is overwritten by the next read. If it is still referenced
+	 * elsewhere, it must copy the data now. */
+	if (Z_TYPE(intern->visitor_data.zchild) == IS_OBJECT && Z_OBJCE(intern->visitor_data.zchild) == php_phongo_document_ce && Z_REFCOUNT(intern->visitor_data.zchild) > 1) {
+		phongo_document_detach(&intern->visitor_data.zchild);
+	}
+
+	zval_ptr_dtor(&intern->visitor_data.zchild);
+	ZVAL_UNDEF(&intern->visitor_data.zchild);
+}
+
+/* Reads the next document from the stream and converts it according to the
+ * type map. At the end of the stream, the current value is left undefined. On
+ * error, an exception will have been thrown. */
+static void php_phongo_reader_advance(php_phongo_reader_t* intern)
+{
+	const bson_t* doc;
+	bool          eof = false;
+
+	php_phongo_reader_free_current(intern);
+
+	if (intern->started) {
+		intern->key++;
+	} else {
+		intern->started = true;
+	}
+
+	if (!(doc = bson_reader_read(intern->reader, &eof))) {
+		/* bson_reader_t reports a truncated document at the end of the stream
+		 * as EOF, so also check that all data read was consumed. */
+		if (!eof || (size_t) bson_reader_tell(intern->reader) != intern->bytes_read) {
+			phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Could not read BSON document from stream at offset %" PRId64, (int64_t) bson_reader_tell(intern->reader));
+		}
+
+		return;
+	}
+
+	if (intern->visitor_data.map.root.type == PHONGO_TYPEMAP_BSON) {
+		phongo_document_new_borrowed(&intern->visitor_data.zchild, doc);
+		return;
+	}
+
+	if (!php_phongo_bson_to_zval_ex(doc, &intern->visitor_data)) {
+		/* Exception already thrown */
+		php_phongo_reader_free_current(intern);
+	}
+}
+
+/* Constructs a reader for a stream of concatenated BSON documents, such as a
+ * mongodump file. Without a type map, documents are returned as
+ * MongoDB\BSON\Document instances. */
+static PHP_METHOD(MongoDB_BSON_Reader, __construct)
+{
+	php_phongo_reader_t* intern;
+	zval*                zstream;
+	zval*                typemap = NULL;
+
+	intern = Z_READER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_START(1, 2)
+	Z_PARAM_RESOURCE(zstream)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_ARRAY_OR_NULL(typemap)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	if (!zend_fetch_resource2_ex(zstream, "stream", php_file_le_stream(), php_file_le_pstream())) {
+		/* Exception already thrown */
+		return;
+	}
+
+	if (intern->reader) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has already been initialized", ZSTR_VAL(php_phongo_reader_ce->name));
+		return;
+	}
+
+	if (typemap) {
+		if (!php_phongo_bson_typemap_to_state(typemap, &intern->visitor_data.map)) {
+			/* Exception already thrown */
+			return;
+		}
+	} else {
+		intern->visitor_data.map.root.type = PHONGO_TYPEMAP_BSON;
+	}
+
+	ZVAL_COPY(&intern->stream, zstream);
+
+	intern->reader = bson_reader_new_from_handle(intern, php_phongo_reader_read_stream, NULL);
+}
+
+static PHP_METHOD(MongoDB_BSON_Reader, current)
+{
+	php_phongo_reader_t* intern = Z_READER_OBJ_P(getThis());
+	zval*                data;
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	data = &intern->visitor_data.zchild;
+
+	if (Z_ISUNDEF_P(data)) {
+		RETURN_NULL();
+	} else {
+		ZVAL_COPY_DEREF(return_value, data);
+	}
+}
+
+static PHP_METHOD(MongoDB_BSON_Reader, key)
+{
+	php_phongo_reader_t* intern = Z_READER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	if (Z_ISUNDEF(intern->visitor_data.zchild)) {
+		RETURN_NULL();
+	}
+
+	RETURN_LONG(intern->key);
+}
+
+static PHP_METHOD(MongoDB_BSON_Reader, next)
+{
+	php_phongo_reader_t* intern = Z_READER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	if (!intern->reader) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has not been initialized", ZSTR_VAL(php_phongo_reader_ce->name));
+		return;
+	}
+
+	php_phongo_reader_advance(intern);
+}
+
+static PHP_METHOD(MongoDB_BSON_Reader, rewind)
+{
+	php_phongo_reader_t* intern = Z_READER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	if (!intern->reader) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has not been initialized", ZSTR_VAL(php_phongo_reader_ce->name));
+		return;
+	}
+
+	/* The underlying stream may not be seekable, so only the first document
+	 * can be revisited. */
+	if (intern->key > 0) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "Readers cannot rewind after starting iteration");
+		return;
+	}
+
+	if (!intern->started) {
+		php_phongo_reader_advance(intern);
+	}
+}
+
+static PHP_METHOD(MongoDB_BSON_Reader, valid)
+{
+	php_phongo_reader_t* intern = Z_READER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	RETURN_BOOL(!Z_ISUNDEF(intern->visitor_data.zchild));
+}
+
+/* MongoDB\BSON\Reader object handlers */
+static zend_object_handlers php_phongo_handler_reader;
+
+static void php_phongo_reader_free_object(zend_object* object)
+{
+	php_phongo_reader_t* intern = Z_OBJ_READER(object);
+
+	zend_object_std_dtor(&intern->std);
+
+	/* Free the current value before destroying the reader, since a borrowed
+	 * Document may need to copy data from the reader's buffer. */
+	php_phongo_reader_free_current(intern);
+
+	if (intern->reader) {
+		bson_reader_destroy(intern->reader);
+	}
+
+	if (!Z_ISUNDEF(intern->stream)) {
+		zval_ptr_dtor(&intern->stream);
+	}
+
+	php_phongo_bson_typemap_dtor(&intern->visitor_data.map);
+}
+
+static zend_object* php_phongo_reader_create_object(zend_class_entry* class_type)
+{
+	php_phongo_reader_t* intern = zend_object_alloc(sizeof(php_phongo_reader_t), class_type);
+
+	zend_object_std_init(&intern->std, class_type);
+	object_properties_init(&intern->std, class_type);
+
+	PHONGO_BSON_INIT_STATE(intern->visitor_data);
+	ZVAL_UNDEF(&intern->stream);
+
+	intern->std.handlers = &php_phongo_handler_reader;
+
+	return &intern->std;
+}
+
+void php_phongo_reader_init_ce(INIT_FUNC_ARGS)
+{
+	php_phongo_reader_ce                = register_class_MongoDB_BSON_Reader(zend_ce_iterator);
+	php_phongo_reader_ce->create_object = php_phongo_reader_create_object;
+
+	memcpy(&php_phongo_handler_reader, phongo_get_std_object_handlers(), sizeof(zend_object_handlers));
+	php_phongo_handler_reader.clone_obj = NULL;
+	php_phongo_handler_reader.free_obj  = php_phongo_reader_free_object;
+	php_phongo_handler_reader.offset    = XtOffsetOf(php_phongo_reader_t, std);
+}
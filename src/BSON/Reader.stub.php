@@ -0,0 +1,25 @@
+<?php
+
+/**
+  * @generate-class-entries static
+  * @generate-function-entries static
+  */
+
+namespace MongoDB\BSON;
+
+/** @not-serializable */
+final class Reader implements \Iterator
+{
+    /** @param resource $stream */
+    final public function __construct($stream, ?array $typeMap = null) {}
+
+    final public function current(): array|object|null {}
+
+    final public function key(): ?int {}
+
+    final public function next(): void {}
+
+    final public function rewind(): void {}
+
+    final public function valid(): bool {}
+}
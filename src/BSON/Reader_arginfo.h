@@ -0,0 +1,52 @@
+/* This is a generated file, edit the .stub.php file instead.
+ * Stub hash: 7d9c5bf4ef22c1be1ea1a7c49ea331ff899fbfd3 */
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_MongoDB_BSON_Reader___construct, 0, 0, 1)
+	ZEND_ARG_INFO(0, stream)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, typeMap, IS_ARRAY, 1, "null")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_MASK_EX(arginfo_class_MongoDB_BSON_Reader_current, 0, 0, MAY_BE_ARRAY|MAY_BE_OBJECT|MAY_BE_NULL)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_BSON_Reader_key, 0, 0, IS_LONG, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_BSON_Reader_next, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+#define arginfo_class_MongoDB_BSON_Reader_rewind arginfo_class_MongoDB_BSON_Reader_next
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_BSON_Reader_valid, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+
+static ZEND_METHOD(MongoDB_BSON_Reader, __construct);
+static ZEND_METHOD(MongoDB_BSON_Reader, current);
+static ZEND_METHOD(MongoDB_BSON_Reader, key);
+static ZEND_METHOD(MongoDB_BSON_Reader, next);
+static ZEND_METHOD(MongoDB_BSON_Reader, rewind);
+static ZEND_METHOD(MongoDB_BSON_Reader, valid);
+
+
+static const zend_function_entry class_MongoDB_BSON_Reader_methods[] = {
+	ZEND_ME(MongoDB_BSON_Reader, __construct, arginfo_class_MongoDB_BSON_Reader___construct, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Reader, current, arginfo_class_MongoDB_BSON_Reader_current, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Reader, key, arginfo_class_MongoDB_BSON_Reader_key, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Reader, next, arginfo_class_MongoDB_BSON_Reader_next, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Reader, rewind, arginfo_class_MongoDB_BSON_Reader_rewind, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Reader, valid, arginfo_class_MongoDB_BSON_Reader_valid, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_FE_END
+};
+
+static zend_class_entry *register_class_MongoDB_BSON_Reader(zend_class_entry *class_entry_Iterator)
+{
+	zend_class_entry ce, *class_entry;
+
+	INIT_NS_CLASS_ENTRY(ce, "MongoDB\\BSON", "Reader", class_MongoDB_BSON_Reader_methods);
+	class_entry = zend_register_internal_class_ex(&ce, NULL);
+	class_entry->ce_flags |= ZEND_ACC_FINAL|ZEND_ACC_NOT_SERIALIZABLE;
+	zend_class_implements(class_entry, 1, class_entry_Iterator);
+
+	return class_entry;
+}
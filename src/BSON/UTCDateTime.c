@@ -156,22 +156,21 @@ static HashTable* php_phongo_utcdatetime_get_properties_hash(zend_object* object
 	return props;
 }
 
-static void php_phongo_utcdatetime_to_php_date(zval* return_value, const zval* this, zend_class_entry* ce)
+/* Initializes a DateTime or DateTimeImmutable object (depending on ce) for the
+ * given number of milliseconds since the Unix epoch. */
+void phongo_utcdatetime_to_php_date(zval* return_value, int64_t milliseconds, zend_class_entry* ce)
 {
-	php_phongo_utcdatetime_t* intern;
-	php_date_obj*             datetime_obj;
-	char*                     sec_str;
-	size_t                    sec_len;
-	int64_t                   sec, usec;
-
-	intern = Z_UTCDATETIME_OBJ_P(this);
+	php_date_obj* datetime_obj;
+	char*         sec_str;
+	size_t        sec_len;
+	int64_t       sec, usec;
 
 	object_init_ex(return_value, ce);
 	datetime_obj = Z_PHPDATE_P(return_value);
 
-	sec  = intern->milliseconds / 1000;
-	usec = (llabs(intern->milliseconds) % 1000) * 1000;
-	if (intern->milliseconds < 0 && usec != 0) {
+	sec  = milliseconds / 1000;
+	usec = (llabs(milliseconds) % 1000) * 1000;
+	if (milliseconds < 0 && usec != 0) {
 		/* For dates before the unix epoch, we need to subtract the microseconds from the timestamp.
 		 * Since we can't directly pass microseconds when calling php_date_initialize due to a bug in PHP,
 		 * we manually decrement the timestamp and subtract the number of microseconds from a full seconds
@@ -268,7 +267,7 @@ static PHP_METHOD(MongoDB_BSON_UTCDateTime, toDateTime)
 {
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	php_phongo_utcdatetime_to_php_date(return_value, getThis(), php_date_get_date_ce());
+	phongo_utcdatetime_to_php_date(return_value, Z_UTCDATETIME_OBJ_P(getThis())->milliseconds, php_date_get_date_ce());
 }
 
 /* Returns a DateTimeImmutable object representing this UTCDateTime */
@@ -276,7 +275,7 @@ static PHP_METHOD(MongoDB_BSON_UTCDateTime, toDateTimeImmutable)
 {
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	php_phongo_utcdatetime_to_php_date(return_value, getThis(), php_date_get_immutable_ce());
+	phongo_utcdatetime_to_php_date(return_value, Z_UTCDATETIME_OBJ_P(getThis())->milliseconds, php_date_get_immutable_ce());
 }
 
 static PHP_METHOD(MongoDB_BSON_UTCDateTime, jsonSerialize)
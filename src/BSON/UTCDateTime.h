@@ -18,5 +18,6 @@
 #define PHONGO_BSON_UTCDATETIME_H
 
 bool phongo_utcdatetime_new(zval* object, int64_t msec_since_epoch);
+void phongo_utcdatetime_to_php_date(zval* return_value, int64_t milliseconds, zend_class_entry* ce);
 
 #endif /* PHONGO_BSON_UTCDATETIME_H */
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2024-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <php.h>
+#include <Zend/zend_interfaces.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "php_phongo.h"
+#include "phongo_bson_encode.h"
+#include "phongo_error.h"
+
+#include "BSON/Writer_arginfo.h"
+
+zend_class_entry* php_phongo_writer_ce;
+
+static void* php_phongo_writer_realloc(void* mem, size_t num_bytes, void* ctx)
+{
+	return erealloc(mem, num_bytes);
+}
+
+/* Writes all buffered documents to the stream, retrying partial writes. The
+ * bson_writer_t is restarted with any bytes that could not be written moved to
+ * the beginning of the buffer, so that buffered documents are only discarded
+ * once they have been written. Returns false and throws an exception on
+ * error. */
+static bool php_phongo_writer_flush(php_phongo_writer_t* intern)
+{
+	php_stream* stream;
+	size_t      length;
+	size_t      total = 0;
+	ssize_t     written;
+
+	if (!intern->writer || !(length = bson_writer_get_length(intern->writer))) {
+		return true;
+	}
+
+	stream = (php_stream*) zend_fetch_resource2(Z_RES(intern->stream), NULL, php_file_le_stream(), php_file_le_pstream());
+	if (!stream) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not write %zu bytes to stream: stream is not open", length);
+		return false;
+	}
+
+	while (total < length) {
+		written = php_stream_write(stream, (const char*) intern->buf + total, length - total);
+
+		if (written <= 0) {
+			break;
+		}
+
+		total += (size_t) written;
+	}
+
+	if (total == 0) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not write %zu bytes to stream", length);
+		return false;
+	}
+
+	if (total < length) {
+		memmove(intern->buf, intern->buf + total, length - total);
+	}
+
+	bson_writer_destroy(intern->writer);
+	intern->writer = bson_writer_new(&intern->buf, &intern->buf_len, length - total, php_phongo_writer_realloc, NULL);
+
+	if (total < length) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not write %zu bytes to stream: only %zu bytes were written", length, total);
+		return false;
+	}
+
+	return true;
+}
+
+/* Constructs a writer that appends BSON documents to a stream. Documents are
+ * encoded into a single buffer, which is written to the stream once it holds
+ * at least bufferSize bytes. */
+static PHP_METHOD(MongoDB_BSON_Writer, __construct)
+{
+	php_phongo_writer_t* intern;
+	zval*                zstream;
+	zend_long            buffer_size = 1048576;
+
+	intern = Z_WRITER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_START(1, 2)
+	Z_PARAM_RESOURCE(zstream)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_LONG(buffer_size)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	if (!zend_fetch_resource2_ex(zstream, "stream", php_file_le_stream(), php_file_le_pstream())) {
+		/* Exception already thrown */
+		return;
+	}
+
+	if (buffer_size < 1 || buffer_size > INT32_MAX) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected bufferSize to be a positive 32-bit integer, %" PHONGO_LONG_FORMAT " given", buffer_size);
+		return;
+	}
+
+	if (intern->writer) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has already been initialized", ZSTR_VAL(php_phongo_writer_ce->name));
+		return;
+	}
+
+	ZVAL_COPY(&intern->stream, zstream);
+
+	intern->buffer_size = (size_t) buffer_size;
+	intern->buf_len     = intern->buffer_size;
+	intern->buf         = emalloc(intern->buf_len);
+	intern->writer      = bson_writer_new(&intern->buf, &intern->buf_len, 0, php_phongo_writer_realloc, NULL);
+}
+
+static PHP_METHOD(MongoDB_BSON_Writer, flush)
+{
+	php_phongo_writer_t* intern = Z_WRITER_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	if (!intern->writer) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has not been initialized", ZSTR_VAL(php_phongo_writer_ce->name));
+		return;
+	}
+
+	php_phongo_writer_flush(intern);
+}
+
+/* Encodes a document directly after the previously written documents in the
+ * writer's buffer and flushes the buffer if it has reached its size. */
+static PHP_METHOD(MongoDB_BSON_Writer, write)
+{
+	php_phongo_writer_t* intern = Z_WRITER_OBJ_P(getThis());
+	zval*                document;
+	bson_t*              bson;
+
+	PHONGO_PARSE_PARAMETERS_START(1, 1)
+	Z_PARAM_ARRAY_OR_OBJECT(document)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	if (!intern->writer) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "%s has not been initialized", ZSTR_VAL(php_phongo_writer_ce->name));
+		return;
+	}
+
+	if (!bson_writer_begin(intern->writer, &bson)) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not begin writing BSON document");
+		return;
+	}
+
+	php_phongo_zval_to_bson(document, PHONGO_BSON_NONE, bson, NULL);
+
+	if (EG(exception)) {
+		/* Discard the partially encoded document */
+		bson_writer_rollback(intern->writer);
+		return;
+	}
+
+	bson_writer_end(intern->writer);
+
+	if (bson_writer_get_length(intern->writer) >= intern->buffer_size) {
+		php_phongo_writer_flush(intern);
+	}
+}
+
+/* MongoDB\BSON\Writer object handlers */
+static zend_object_handlers php_phongo_handler_writer;
+
+/* Buffered documents are written out when the object is destroyed, while the
+ * stream (which the writer holds a reference to) is still open. */
+static void php_phongo_writer_dtor_object(zend_object* object)
+{
+	php_phongo_writer_t* intern = Z_OBJ_WRITER(object);
+
+	zend_objects_destroy_object(object);
+
+	if (!EG(exception)) {
+		php_phongo_writer_flush(intern);
+	}
+}
+
+static void php_phongo_writer_free_object(zend_object* object)
+{
+	php_phongo_writer_t* intern = Z_OBJ_WRITER(object);
+
+	zend_object_std_dtor(&intern->std);
+
+	if (intern->writer) {
+		bson_writer_destroy(intern->writer);
+	}
+
+	if (intern->buf) {
+		efree(intern->buf);
+	}
+
+	if (!Z_ISUNDEF(intern->stream)) {
+		zval_ptr_dtor(&intern->stream);
+	}
+}
+
+static zend_object* php_phongo_writer_create_object(zend_class_entry* class_type)
+{
+	php_phongo_writer_t* intern = zend_object_alloc(sizeof(php_phongo_writer_t), class_type);
+
+	zend_object_std_init(&intern->std, class_type);
+	object_properties_init(&intern->std, class_type);
+
+	ZVAL_UNDEF(&intern->stream);
+
+	intern->std.handlers = &php_phongo_handler_writer;
+
+	return &intern->std;
+}
+
+void php_phongo_writer_init_ce(INIT_FUNC_ARGS)
+{
+	php_phongo_writer_ce                = register_class_MongoDB_BSON_Writer();
+	php_phongo_writer_ce->create_object = php_phongo_writer_create_object;
+
+	memcpy(&php_phongo_handler_writer, phongo_get_std_object_handlers(), sizeof(zend_object_handlers));
+	php_phongo_handler_writer.clone_obj = NULL;
+	php_phongo_handler_writer.dtor_obj  = php_phongo_writer_dtor_object;
+	php_phongo_handler_writer.free_obj  = php_phongo_writer_free_object;
+	php_phongo_handler_writer.offset    = XtOffsetOf(php_phongo_writer_t, std);
+}
@@ -0,0 +1,19 @@
+<?php
+
+/**
+  * @generate-class-entries static
+  * @generate-function-entries static
+  */
+
+namespace MongoDB\BSON;
+
+/** @not-serializable */
+final class Writer
+{
+    /** @param resource $stream */
+    final public function __construct($stream, int $bufferSize = 1048576) {}
+
+    final public function flush(): void {}
+
+    final public function write(array|object $document): void {}
+}
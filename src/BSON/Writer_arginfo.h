@@ -0,0 +1,38 @@
+/* This is a generated file, edit the .stub.php file instead.
+ * Stub hash: 1d8ff7ed63f98fa6d8c038c768fc7a240d54b5d6 */
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_MongoDB_BSON_Writer___construct, 0, 0, 1)
+	ZEND_ARG_INFO(0, stream)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, bufferSize, IS_LONG, 0, "1048576")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_BSON_Writer_flush, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_BSON_Writer_write, 0, 1, IS_VOID, 0)
+	ZEND_ARG_TYPE_MASK(0, document, MAY_BE_ARRAY|MAY_BE_OBJECT, NULL)
+ZEND_END_ARG_INFO()
+
+
+static ZEND_METHOD(MongoDB_BSON_Writer, __construct);
+static ZEND_METHOD(MongoDB_BSON_Writer, flush);
+static ZEND_METHOD(MongoDB_BSON_Writer, write);
+
+
+static const zend_function_entry class_MongoDB_BSON_Writer_methods[] = {
+	ZEND_ME(MongoDB_BSON_Writer, __construct, arginfo_class_MongoDB_BSON_Writer___construct, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Writer, flush, arginfo_class_MongoDB_BSON_Writer_flush, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_BSON_Writer, write, arginfo_class_MongoDB_BSON_Writer_write, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_FE_END
+};
+
+static zend_class_entry *register_class_MongoDB_BSON_Writer(void)
+{
+	zend_class_entry ce, *class_entry;
+
+	INIT_NS_CLASS_ENTRY(ce, "MongoDB\\BSON", "Writer", class_MongoDB_BSON_Writer_methods);
+	class_entry = zend_register_internal_class_ex(&ce, NULL);
+	class_entry->ce_flags |= ZEND_ACC_FINAL|ZEND_ACC_NOT_SERIALIZABLE;
+
+	return class_entry;
+}
@@ -25,18 +25,20 @@
 /* Returns the BSON representation of a PHP value */
 PHP_FUNCTION(MongoDB_BSON_fromPHP)
 {
-	zval*   data;
-	bson_t* bson;
+	zval*        data;
+	zend_string* bson;
 
 	PHONGO_PARSE_PARAMETERS_START(1, 1)
 	Z_PARAM_ARRAY_OR_OBJECT(data)
 	PHONGO_PARSE_PARAMETERS_END();
 
-	bson = bson_new();
-	php_phongo_zval_to_bson(data, PHONGO_BSON_NONE, bson, NULL);
+	/* The document is encoded directly into the returned string */
+	if (!(bson = php_phongo_zval_to_bson_string(data, PHONGO_BSON_NONE))) {
+		// Exception already thrown
+		return;
+	}
 
-	RETVAL_STRINGL((const char*) bson_get_data(bson), bson->len);
-	bson_destroy(bson);
+	RETVAL_STR(bson);
 }
 
 /* Returns the PHP representation of a BSON value, optionally converting it into a custom class */
@@ -18,6 +18,7 @@
 #include "mongoc/mongoc.h"
 
 #include <php.h>
+#include <ext/spl/spl_iterators.h>
 #include <Zend/zend_interfaces.h>
 
 #include "php_array_api.h"
@@ -33,27 +34,93 @@
 
 zend_class_entry* php_phongo_bulkwrite_ce;
 
-/* Extracts the "_id" field of a BSON document into a return value. */
-static void php_phongo_bulkwrite_extract_id(bson_t* doc, zval** return_value)
+/* Extracts the "_id" field of an encoded document into a zval. The value is
+ * converted as it would be when decoding the document with a native array type
+ * map. Returns false and throws an exception on error. */
+static bool php_phongo_bulkwrite_extract_id(const bson_t* doc, zval* zid)
 {
-	zval*                 id = NULL;
-	php_phongo_bson_state state;
+	bson_iter_t iter;
 
-	PHONGO_BSON_INIT_STATE(state);
-	state.map.root.type = PHONGO_TYPEMAP_NATIVE_ARRAY;
+	if (!bson_iter_init_find(&iter, doc, "_id")) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "Did not receive result from bulk write. Please file a bug report.");
+		return false;
+	}
 
-	if (!php_phongo_bson_to_zval_ex(doc, &state)) {
-		goto cleanup;
+	if (BSON_ITER_HOLDS_INT64(&iter)) {
+		ZVAL_INT64(zid, bson_iter_int64(&iter));
+		return true;
 	}
 
-	id = php_array_fetchc(&state.zchild, "_id");
+	return phongo_bson_value_to_zval_legacy(bson_iter_value(&iter), zid);
+}
+
+/* Encodes a document, generating an "_id" if necessary, and adds it to the
+ * bulk as an insert operation. The bdocument buffer is reinitialized, so its
+ * allocation can be reused for successive documents. If zid is not NULL, it
+ * will be set to the document's "_id". Returns false and throws an exception on
+ * error. */
+static bool php_phongo_bulkwrite_insert_document(php_phongo_bulkwrite_t* intern, zval* zdocument, bson_t* bdocument, zval* zid)
+{
+	bson_error_t error = { 0 };
 
-	if (id) {
-		ZVAL_ZVAL(*return_value, id, 1, 0);
+	bson_reinit(bdocument);
+
+	php_phongo_zval_to_bson(zdocument, PHONGO_BSON_ADD_ID, bdocument, NULL);
+
+	if (EG(exception)) {
+		return false;
 	}
 
-cleanup:
-	zval_ptr_dtor(&state.zchild);
+	if (!mongoc_bulk_operation_insert_with_opts(intern->bulk, bdocument, NULL, &error)) {
+		phongo_throw_exception_from_bson_error_t(&error);
+		return false;
+	}
+
+	intern->num_ops++;
+
+	return !zid || php_phongo_bulkwrite_extract_id(bdocument, zid);
+}
+
+typedef struct {
+	php_phongo_bulkwrite_t* intern;
+	bson_t*                 bdocument;
+	zval*                   ids;
+} php_phongo_bulkwrite_insert_many_ctx;
+
+/* Adds a single document to the bulk for insertMany(), appending its "_id" to
+ * the list of identifiers if one is being collected. */
+static bool php_phongo_bulkwrite_insert_many_document(php_phongo_bulkwrite_insert_many_ctx* ctx, zval* zdocument)
+{
+	zval zid;
+
+	ZVAL_DEREF(zdocument);
+
+	if (Z_TYPE_P(zdocument) != IS_ARRAY && Z_TYPE_P(zdocument) != IS_OBJECT) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected document to be array or object, %s given", zend_get_type_by_const(Z_TYPE_P(zdocument)));
+		return false;
+	}
+
+	if (!php_phongo_bulkwrite_insert_document(ctx->intern, zdocument, ctx->bdocument, ctx->ids ? &zid : NULL)) {
+		return false;
+	}
+
+	if (ctx->ids) {
+		add_next_index_zval(ctx->ids, &zid);
+	}
+
+	return true;
+}
+
+static int php_phongo_bulkwrite_insert_many_apply(zend_object_iterator* iter, void* puser)
+{
+	php_phongo_bulkwrite_insert_many_ctx* ctx = (php_phongo_bulkwrite_insert_many_ctx*) puser;
+	zval*                                 data;
+
+	if (!(data = iter->funcs->get_current_data(iter))) {
+		return ZEND_HASH_APPLY_STOP;
+	}
+
+	return php_phongo_bulkwrite_insert_many_document(ctx, data) ? ZEND_HASH_APPLY_KEEP : ZEND_HASH_APPLY_STOP;
 }
 
 /* Returns whether any top-level field names in the document contain a "$". */
@@ -380,10 +447,7 @@ static PHP_METHOD(MongoDB_Driver_BulkWrite, insert)
 {
 	php_phongo_bulkwrite_t* intern;
 	zval*                   zdocument;
-	bson_t                  bdocument = BSON_INITIALIZER, boptions = BSON_INITIALIZER;
-	bson_t*                 bson_out   = NULL;
-	int                     bson_flags = PHONGO_BSON_ADD_ID;
-	bson_error_t            error      = { 0 };
+	bson_t                  bdocument = BSON_INITIALIZER;
 
 	intern = Z_BULKWRITE_OBJ_P(getThis());
 
@@ -391,32 +455,59 @@ static PHP_METHOD(MongoDB_Driver_BulkWrite, insert)
 	Z_PARAM_ARRAY_OR_OBJECT(zdocument)
 	PHONGO_PARSE_PARAMETERS_END();
 
-	bson_flags |= PHONGO_BSON_RETURN_ID;
+	php_phongo_bulkwrite_insert_document(intern, zdocument, &bdocument, return_value);
 
-	php_phongo_zval_to_bson(zdocument, bson_flags, &bdocument, &bson_out);
+	bson_destroy(&bdocument);
+}
 
-	if (EG(exception)) {
-		goto cleanup;
-	}
+/* Adds an insert operation to the BulkWrite for each document. Documents are
+ * encoded into a single reused buffer. If returnIds is true, the "_id" values
+ * of the documents are returned in order; otherwise, null is returned. If a
+ * document cannot be added, any previous documents will remain in the bulk. */
+static PHP_METHOD(MongoDB_Driver_BulkWrite, insertMany)
+{
+	php_phongo_bulkwrite_insert_many_ctx ctx;
+	zval*                                zdocuments;
+	zend_bool                            return_ids = true;
+	bson_t                               bdocument  = BSON_INITIALIZER;
+	bool                                 success    = true;
 
-	if (!mongoc_bulk_operation_insert_with_opts(intern->bulk, &bdocument, &boptions, &error)) {
-		phongo_throw_exception_from_bson_error_t(&error);
-		goto cleanup;
-	}
+	PHONGO_PARSE_PARAMETERS_START(1, 2)
+	Z_PARAM_ITERABLE(zdocuments)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_BOOL(return_ids)
+	PHONGO_PARSE_PARAMETERS_END();
 
-	intern->num_ops++;
+	ctx.intern    = Z_BULKWRITE_OBJ_P(getThis());
+	ctx.bdocument = &bdocument;
+	ctx.ids       = NULL;
 
-	if (!bson_out) {
-		phongo_throw_exception(PHONGO_ERROR_LOGIC, "Did not receive result from bulk write. Please file a bug report.");
-		goto cleanup;
+	if (return_ids) {
+		array_init_size(return_value, Z_TYPE_P(zdocuments) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL_P(zdocuments)) : 0);
+		ctx.ids = return_value;
 	}
 
-	php_phongo_bulkwrite_extract_id(bson_out, &return_value);
+	if (Z_TYPE_P(zdocuments) == IS_ARRAY) {
+		zval* zdocument;
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zdocuments), zdocument)
+		{
+			if (!(success = php_phongo_bulkwrite_insert_many_document(&ctx, zdocument))) {
+				break;
+			}
+		}
+		ZEND_HASH_FOREACH_END();
+	} else {
+		spl_iterator_apply(zdocuments, php_phongo_bulkwrite_insert_many_apply, &ctx);
+	}
 
-cleanup:
 	bson_destroy(&bdocument);
-	bson_destroy(&boptions);
-	bson_clear(&bson_out);
+
+	if (!success || EG(exception)) {
+		/* Exception already thrown */
+		zval_ptr_dtor(return_value);
+		ZVAL_NULL(return_value);
+	}
 }
 
 /* Adds an update operation to the BulkWrite */
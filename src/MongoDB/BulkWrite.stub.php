@@ -18,5 +18,7 @@ final class BulkWrite implements \Countable
 
     final public function insert(array|object $document): mixed {}
 
+    final public function insertMany(iterable $documents, bool $returnIds = true): ?array {}
+
     public function update(array|object $filter, array|object $newObj, ?array $updateOptions = null): void {}
 }
@@ -775,7 +775,7 @@ static mongoc_client_encryption_datakey_opts_t* phongo_clientencryption_datakey_
 			goto cleanup;
 		}
 
-		mongoc_client_encryption_datakey_opts_set_keymaterial(opts, (uint8_t*) Z_BINARY_OBJ_P(keyMaterial)->data, Z_BINARY_OBJ_P(keyMaterial)->data_len);
+		mongoc_client_encryption_datakey_opts_set_keymaterial(opts, (uint8_t*) ZSTR_VAL(Z_BINARY_OBJ_P(keyMaterial)->data), ZSTR_LEN(Z_BINARY_OBJ_P(keyMaterial)->data));
 	}
 
 	if (php_array_existsc(options, "masterKey")) {
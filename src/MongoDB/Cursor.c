@@ -15,6 +15,7 @@
  */
 
 #include <php.h>
+#include <zend_smart_str.h>
 #include <ext/spl/spl_iterators.h>
 #include <Zend/zend_interfaces.h>
 
@@ -24,10 +25,19 @@
 #include "phongo_error.h"
 #include "phongo_util.h"
 
+#include "BSON/Document.h"
+#include "BSON/PackedArray.h"
 #include "MongoDB/Cursor.h"
 #include "MongoDB/Server.h"
 #include "Cursor_arginfo.h"
 
+/* Number of documents returned by nextBatch() if the cursor has no batch size.
+ * This corresponds to the server's default size for an initial batch. */
+#define PHONGO_CURSOR_DEFAULT_BATCH_SIZE 101
+
+/* Number of bytes buffered by writeTo() before writing to the stream */
+#define PHONGO_CURSOR_WRITE_BUFFER_SIZE 1048576
+
 zend_class_entry* php_phongo_cursor_ce;
 
 /* Check if the cursor is exhausted (i.e. ID is zero) and free any reference to
@@ -48,12 +58,187 @@ static void php_phongo_cursor_free_session_if_exhausted(php_phongo_cursor_t* cur
 
 static void php_phongo_cursor_free_current(php_phongo_cursor_t* cursor)
 {
+	cursor->current_deferred = false;
+
 	if (!Z_ISUNDEF(cursor->visitor_data.zchild)) {
+		/* A Document created for the "bson" root type references libmongoc's
+		 * current result, which is invalidated when the cursor advances. If it
+		 * is still referenced elsewhere, it must copy the data now. */
+		if (Z_TYPE(cursor->visitor_data.zchild) == IS_OBJECT && Z_OBJCE(cursor->visitor_data.zchild) == php_phongo_document_ce && Z_REFCOUNT(cursor->visitor_data.zchild) > 1) {
+			phongo_document_detach(&cursor->visitor_data.zchild);
+		}
+
 		zval_ptr_dtor(&cursor->visitor_data.zchild);
 		ZVAL_UNDEF(&cursor->visitor_data.zchild);
 	}
 }
 
+/* Converts a result document according to the cursor's type map. If the root
+ * type is "bson", the resulting Document borrows the result's data instead of
+ * copying it (see php_phongo_cursor_free_current). On error, an exception will
+ * have been thrown and false will be returned. */
+static bool php_phongo_cursor_build_current(php_phongo_cursor_t* cursor, const bson_t* doc)
+{
+	if (cursor->visitor_data.map.root.type == PHONGO_TYPEMAP_BSON) {
+		return phongo_document_new_borrowed(&cursor->visitor_data.zchild, doc);
+	}
+
+	return php_phongo_bson_to_zval_ex(doc, &cursor->visitor_data);
+}
+
+/* Returns whether the cursor is positioned on a result, which may not have
+ * been converted yet (see php_phongo_cursor_build_deferred_current). */
+static bool php_phongo_cursor_has_current(php_phongo_cursor_t* cursor)
+{
+	return cursor->current_deferred || !Z_ISUNDEF(cursor->visitor_data.zchild);
+}
+
+/* Converts libmongoc's current result if nextBatch() left the cursor
+ * positioned on it without converting it. On error, an exception will have
+ * been thrown and false will be returned. */
+static bool php_phongo_cursor_build_deferred_current(php_phongo_cursor_t* cursor)
+{
+	if (!cursor->current_deferred) {
+		return true;
+	}
+
+	cursor->current_deferred = false;
+
+	if (!php_phongo_cursor_build_current(cursor, mongoc_cursor_current(cursor->cursor))) {
+		php_phongo_cursor_free_current(cursor);
+		return false;
+	}
+
+	return true;
+}
+
+/* Records the size of a result for the adaptive batch size */
+static void php_phongo_cursor_observe_result(php_phongo_cursor_t* cursor, const bson_t* doc)
+{
+	if (!cursor->adaptive_batch.target_bytes || !doc) {
+		return;
+	}
+
+	cursor->adaptive_batch.observed_bytes += doc->len;
+	cursor->adaptive_batch.observed_documents++;
+}
+
+/* Sets the batch size for subsequent getMore commands so that a batch of
+ * results of the average size observed so far approaches the target size. This
+ * is called before every advance of the libmongoc cursor, including within a
+ * batch, so the batch size reported by libmongoc is the one that the next
+ * getMore will use rather than the size of the batch currently being read. */
+static void php_phongo_cursor_update_batch_size(php_phongo_cursor_t* cursor)
+{
+	php_phongo_cursor_adaptive_batch_t* adaptive = &cursor->adaptive_batch;
+	uint64_t                            batch_size;
+
+	if (!adaptive->target_bytes || !adaptive->observed_documents) {
+		return;
+	}
+
+	batch_size = adaptive->target_bytes / (adaptive->observed_bytes / adaptive->observed_documents);
+
+	if (batch_size < adaptive->min_batch_size) {
+		batch_size = adaptive->min_batch_size;
+	} else if (batch_size > adaptive->max_batch_size) {
+		batch_size = adaptive->max_batch_size;
+	}
+
+	if (batch_size != adaptive->batch_size) {
+		adaptive->batch_size = (uint32_t) batch_size;
+		mongoc_cursor_set_batch_size(cursor->cursor, adaptive->batch_size);
+	}
+}
+
+/* Advances the libmongoc cursor and converts the next result, unless
+ * build_current is false. Returns the next result document, or NULL if the
+ * cursor is exhausted or an error occurred (in which case an exception will
+ * have been thrown). */
+static const bson_t* php_phongo_cursor_advance(php_phongo_cursor_t* cursor, bool build_current)
+{
+	const bson_t* doc = NULL;
+
+	php_phongo_cursor_free_current(cursor);
+
+	/* If the cursor has already advanced, increment its position. Otherwise,
+	 * the first call to mongoc_cursor_next() will be made below and we should
+	 * leave its position at zero. */
+	if (cursor->advanced) {
+		cursor->current++;
+	} else {
+		cursor->advanced = true;
+	}
+
+	php_phongo_cursor_update_batch_size(cursor);
+
+	if (mongoc_cursor_next(cursor->cursor, &doc)) {
+		php_phongo_cursor_observe_result(cursor, doc);
+
+		if (build_current && !php_phongo_cursor_build_current(cursor, doc)) {
+			/* Free invalid result, but don't return as we want to free the
+			 * session if the cursor is exhausted. */
+			php_phongo_cursor_free_current(cursor);
+		}
+	} else {
+		bson_error_t  error = { 0 };
+		const bson_t* reply = NULL;
+
+		if (mongoc_cursor_error_document(cursor->cursor, &error, &reply)) {
+			/* Intentionally not destroying the cursor as it will happen
+			 * naturally now that there are no more results */
+			phongo_throw_exception_from_bson_error_t_and_reply(&error, reply);
+		}
+	}
+
+	php_phongo_cursor_free_session_if_exhausted(cursor);
+
+	return doc;
+}
+
+/* Rewinds the cursor, which is only possible before iteration has started.
+ * If build_current is false, converting the first result is deferred until it
+ * is accessed. Returns false and throws an exception on error. */
+static bool php_phongo_cursor_rewind(php_phongo_cursor_t* cursor, bool build_current)
+{
+	const bson_t* doc;
+
+	/* If the cursor was never advanced (e.g. command cursor), do so now */
+	if (!cursor->advanced) {
+		cursor->advanced = true;
+
+		if (!phongo_cursor_advance_and_check_for_error(cursor->cursor)) {
+			/* Exception should already have been thrown */
+			return false;
+		}
+	}
+
+	if (cursor->current > 0) {
+		phongo_throw_exception(PHONGO_ERROR_LOGIC, "Cursors cannot rewind after starting iteration");
+		return false;
+	}
+
+	php_phongo_cursor_free_current(cursor);
+
+	doc = mongoc_cursor_current(cursor->cursor);
+
+	if (doc) {
+		php_phongo_cursor_observe_result(cursor, doc);
+
+		if (!build_current) {
+			cursor->current_deferred = true;
+		} else if (!php_phongo_cursor_build_current(cursor, doc)) {
+			/* Free invalid result, but don't return as we want to free the
+			 * session if the cursor is exhausted. */
+			php_phongo_cursor_free_current(cursor);
+		}
+	}
+
+	php_phongo_cursor_free_session_if_exhausted(cursor);
+
+	return true;
+}
+
 /* Sets a type map to use for BSON unserialization */
 static PHP_METHOD(MongoDB_Driver_Cursor, setTypeMap)
 {
@@ -90,12 +275,58 @@ static PHP_METHOD(MongoDB_Driver_Cursor, setTypeMap)
 	if (restore_current_element && mongoc_cursor_current(intern->cursor)) {
 		const bson_t* doc = mongoc_cursor_current(intern->cursor);
 
-		if (!php_phongo_bson_to_zval_ex(doc, &intern->visitor_data)) {
+		if (!php_phongo_cursor_build_current(intern, doc)) {
 			php_phongo_cursor_free_current(intern);
 		}
 	}
 }
 
+/* Enables an adaptive batch size, which is applied to subsequent getMore
+ * commands. The batch size is chosen so that a batch of results of the average
+ * size observed so far is close to targetBatchBytes, within the given bounds. */
+static PHP_METHOD(MongoDB_Driver_Cursor, setAdaptiveBatchSize)
+{
+	php_phongo_cursor_t* intern;
+	zend_long            target_bytes;
+	zend_long            min_batch_size = 1;
+	zend_long            max_batch_size = INT32_MAX;
+
+	intern = Z_CURSOR_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_START(1, 3)
+	Z_PARAM_LONG(target_bytes)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_LONG(min_batch_size)
+	Z_PARAM_LONG(max_batch_size)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	if (target_bytes < 1 || target_bytes > INT32_MAX) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected targetBatchBytes to be a positive 32-bit integer, %" PHONGO_LONG_FORMAT " given", target_bytes);
+		return;
+	}
+
+	if (min_batch_size < 1 || min_batch_size > INT32_MAX) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected minBatchSize to be a positive 32-bit integer, %" PHONGO_LONG_FORMAT " given", min_batch_size);
+		return;
+	}
+
+	if (max_batch_size < min_batch_size || max_batch_size > INT32_MAX) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected maxBatchSize to be a 32-bit integer greater than or equal to minBatchSize, %" PHONGO_LONG_FORMAT " given", max_batch_size);
+		return;
+	}
+
+	intern->adaptive_batch.target_bytes   = (uint32_t) target_bytes;
+	intern->adaptive_batch.min_batch_size = (uint32_t) min_batch_size;
+	intern->adaptive_batch.max_batch_size = (uint32_t) max_batch_size;
+	intern->adaptive_batch.batch_size     = mongoc_cursor_get_batch_size(intern->cursor);
+
+	/* Account for the current result, which was read before adaptation was
+	 * enabled */
+	if (php_phongo_cursor_has_current(intern)) {
+		php_phongo_cursor_observe_result(intern, mongoc_cursor_current(intern->cursor));
+	}
+}
+
 static int php_phongo_cursor_to_array_apply(zend_object_iterator* iter, void* puser)
 {
 	zval* data;
@@ -192,6 +423,11 @@ static PHP_METHOD(MongoDB_Driver_Cursor, current)
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
+	if (!php_phongo_cursor_build_deferred_current(intern)) {
+		/* Exception already thrown */
+		return;
+	}
+
 	data = &intern->visitor_data.zchild;
 
 	if (Z_ISUNDEF_P(data)) {
@@ -207,7 +443,7 @@ static PHP_METHOD(MongoDB_Driver_Cursor, key)
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	if (Z_ISUNDEF(intern->visitor_data.zchild)) {
+	if (!php_phongo_cursor_has_current(intern)) {
 		RETURN_NULL();
 	}
 
@@ -217,85 +453,338 @@ static PHP_METHOD(MongoDB_Driver_Cursor, key)
 static PHP_METHOD(MongoDB_Driver_Cursor, next)
 {
 	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
-	const bson_t*        doc;
 
 	PHONGO_PARSE_PARAMETERS_NONE();
 
-	php_phongo_cursor_free_current(intern);
+	php_phongo_cursor_advance(intern, true);
+}
 
-	/* If the intern has already advanced, increment its position. Otherwise,
-	 * the first call to mongoc_cursor_next() will be made below and we should
-	 * leave its position at zero. */
-	if (intern->advanced) {
-		intern->current++;
-	} else {
-		intern->advanced = true;
+static PHP_METHOD(MongoDB_Driver_Cursor, valid)
+{
+	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	RETURN_BOOL(php_phongo_cursor_has_current(intern));
+}
+
+static PHP_METHOD(MongoDB_Driver_Cursor, rewind)
+{
+	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
+
+	PHONGO_PARSE_PARAMETERS_NONE();
+
+	php_phongo_cursor_rewind(intern, true);
+}
+
+/* Returns the next results, up to the cursor's batch size at the time of the
+ * call. Batches are counted from the cursor's position, so they need not align
+ * with the batches returned by the server and may span a getMore. If raw is
+ * true, the documents are returned as a single PackedArray without being
+ * decoded, and the cursor is left positioned on its next result without
+ * decoding it either. */
+static PHP_METHOD(MongoDB_Driver_Cursor, nextBatch)
+{
+	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
+	zend_bool            raw    = false;
+	uint32_t             batch_size;
+	uint32_t             count = 0;
+
+	PHONGO_PARSE_PARAMETERS_START(0, 1)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_BOOL(raw)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	/* Start iteration if necessary, as foreach and toArray() would */
+	if (intern->current == 0 && !php_phongo_cursor_has_current(intern)) {
+		if (!php_phongo_cursor_rewind(intern, !raw)) {
+			/* Exception already thrown */
+			return;
+		}
 	}
 
-	if (mongoc_cursor_next(intern->cursor, &doc)) {
-		if (!php_phongo_bson_to_zval_ex(doc, &intern->visitor_data)) {
-			/* Free invalid result, but don't return as we want to free the
-			 * session if the intern is exhausted. */
+	batch_size = mongoc_cursor_get_batch_size(intern->cursor);
+
+	if (batch_size == 0) {
+		batch_size = PHONGO_CURSOR_DEFAULT_BATCH_SIZE;
+	}
+
+	if (raw) {
+		bson_t*       batch = bson_new();
+		const bson_t* doc   = php_phongo_cursor_has_current(intern) ? mongoc_cursor_current(intern->cursor) : NULL;
+
+		/* Documents are appended straight from libmongoc's results, so the
+		 * current result does not need to be converted */
+		if (doc) {
 			php_phongo_cursor_free_current(intern);
 		}
-	} else {
-		bson_error_t  error = { 0 };
-		const bson_t* doc   = NULL;
 
-		if (mongoc_cursor_error_document(intern->cursor, &error, &doc)) {
-			/* Intentionally not destroying the intern as it will happen
-			 * naturally now that there are no more results */
-			phongo_throw_exception_from_bson_error_t_and_reply(&error, doc);
+		while (doc && count < batch_size) {
+			const char* key;
+			char        key_buf[16];
+			size_t      key_len = bson_uint32_to_string(count, &key, key_buf, sizeof(key_buf));
+
+			if (!bson_append_document(batch, key, key_len, doc)) {
+				/* Leave the cursor positioned on the document that could not be
+				 * appended, so that it is not lost */
+				intern->current_deferred = true;
+				bson_destroy(batch);
+
+				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Could not append document %" PRIu32 " to batch: the batch would exceed the maximum BSON document size", count);
+				return;
+			}
+
+			count++;
+
+			doc = php_phongo_cursor_advance(intern, false);
+
+			if (EG(exception)) {
+				bson_destroy(batch);
+				return;
+			}
 		}
+
+		/* Leave the cursor positioned on its next result, as next() would.
+		 * Converting it is deferred until it is accessed. */
+		intern->current_deferred = doc != NULL;
+
+		phongo_packedarray_new(return_value, batch, false);
+		return;
 	}
 
-	php_phongo_cursor_free_session_if_exhausted(intern);
-}
+	if (!php_phongo_cursor_build_deferred_current(intern)) {
+		/* Exception already thrown */
+		return;
+	}
 
-static PHP_METHOD(MongoDB_Driver_Cursor, valid)
-{
-	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
+	array_init(return_value);
 
-	PHONGO_PARSE_PARAMETERS_NONE();
+	while (!Z_ISUNDEF(intern->visitor_data.zchild) && count < batch_size) {
+		Z_TRY_ADDREF(intern->visitor_data.zchild);
+		add_next_index_zval(return_value, &intern->visitor_data.zchild);
+		count++;
+
+		php_phongo_cursor_advance(intern, true);
 
-	RETURN_BOOL(!Z_ISUNDEF(intern->visitor_data.zchild));
+		if (EG(exception)) {
+			zval_ptr_dtor(return_value);
+			RETURN_NULL();
+		}
+	}
 }
 
-static PHP_METHOD(MongoDB_Driver_Cursor, rewind)
+/* Returns the values of the given field paths in all remaining results as one
+ * list per field path, without converting the results to PHP values. A missing
+ * field is returned as null. Embedded documents and arrays are returned as
+ * Document and PackedArray instances, and 64-bit integers as native integers
+ * where possible, as is the default when iterating a cursor. */
+static PHP_METHOD(MongoDB_Driver_Cursor, toColumns)
 {
 	php_phongo_cursor_t* intern = Z_CURSOR_OBJ_P(getThis());
+	HashTable*           field_paths;
+	zend_string**        paths;
+	zval*                columns;
+	zval*                field_path;
+	uint32_t             num_paths;
+	uint32_t             i = 0;
 	const bson_t*        doc;
 
-	PHONGO_PARSE_PARAMETERS_NONE();
+	PHONGO_PARSE_PARAMETERS_START(1, 1)
+	Z_PARAM_ARRAY_HT(field_paths)
+	PHONGO_PARSE_PARAMETERS_END();
 
-	/* If the cursor was never advanced (e.g. command cursor), do so now */
-	if (!intern->advanced) {
-		intern->advanced = true;
+	num_paths = zend_hash_num_elements(field_paths);
 
-		if (!phongo_cursor_advance_and_check_for_error(intern->cursor)) {
-			/* Exception should already have been thrown */
+	ZEND_HASH_FOREACH_VAL(field_paths, field_path)
+	{
+		ZVAL_DEREF(field_path);
+
+		if (Z_TYPE_P(field_path) != IS_STRING) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected field paths to be strings, %s given", zend_zval_type_name(field_path));
+			return;
+		}
+
+		if (Z_STRLEN_P(field_path) == 0) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Field paths may not be empty strings");
 			return;
 		}
 	}
+	ZEND_HASH_FOREACH_END();
 
-	if (intern->current > 0) {
-		phongo_throw_exception(PHONGO_ERROR_LOGIC, "Cursors cannot rewind after starting iteration");
+	/* Start iteration if necessary, as foreach and toArray() would */
+	if (intern->current == 0 && !php_phongo_cursor_has_current(intern)) {
+		if (!php_phongo_cursor_rewind(intern, false)) {
+			/* Exception already thrown */
+			return;
+		}
+	}
+
+	paths   = safe_emalloc(num_paths, sizeof(zend_string*), 0);
+	columns = safe_emalloc(num_paths, sizeof(zval), 0);
+
+	ZEND_HASH_FOREACH_VAL(field_paths, field_path)
+	{
+		ZVAL_DEREF(field_path);
+
+		paths[i] = Z_STR_P(field_path);
+		array_init(&columns[i]);
+		i++;
+	}
+	ZEND_HASH_FOREACH_END();
+
+	doc = php_phongo_cursor_has_current(intern) ? mongoc_cursor_current(intern->cursor) : NULL;
+
+	while (doc) {
+		for (i = 0; i < num_paths; i++) {
+			bson_iter_t iter;
+			bson_iter_t child;
+			zval        value;
+
+			if (!bson_iter_init(&iter, doc) || !bson_iter_find_descendant(&iter, ZSTR_VAL(paths[i]), &child)) {
+				ZVAL_NULL(&value);
+			} else if (BSON_ITER_HOLDS_INT64(&child)) {
+				ZVAL_INT64(&value, bson_iter_int64(&child));
+			} else if (!phongo_bson_value_to_zval(bson_iter_value(&child), &value)) {
+				/* Exception already thrown */
+				goto cleanup;
+			}
+
+			zend_hash_next_index_insert_new(Z_ARRVAL(columns[i]), &value);
+		}
+
+		doc = php_phongo_cursor_advance(intern, false);
+
+		if (EG(exception)) {
+			goto cleanup;
+		}
+	}
+
+	array_init_size(return_value, num_paths);
+
+	for (i = 0; i < num_paths; i++) {
+		zend_symtable_update(Z_ARRVAL_P(return_value), paths[i], &columns[i]);
+	}
+
+	efree(paths);
+	efree(columns);
+	return;
+
+cleanup:
+	for (i = 0; i < num_paths; i++) {
+		zval_ptr_dtor(&columns[i]);
+	}
+
+	efree(paths);
+	efree(columns);
+}
+
+/* Writes the contents of the buffer to the stream and resets the buffer.
+ * Returns false and throws an exception on error. */
+static bool php_phongo_cursor_flush_buffer(php_stream* stream, smart_str* buf)
+{
+	size_t  length;
+	ssize_t written;
+
+	if (!buf->s || !(length = ZSTR_LEN(buf->s))) {
+		return true;
+	}
+
+	written = php_stream_write(stream, ZSTR_VAL(buf->s), length);
+	ZSTR_LEN(buf->s) = 0;
+
+	if (written < 0 || (size_t) written != length) {
+		phongo_throw_exception(PHONGO_ERROR_RUNTIME, "Could not write %zu bytes to stream", length);
+		return false;
+	}
+
+	return true;
+}
+
+/* Writes all remaining results to a stream without converting them to PHP
+ * values. Results are written as concatenated BSON documents or as Extended
+ * JSON with one document per line. Returns the number of documents written. */
+static PHP_METHOD(MongoDB_Driver_Cursor, writeTo)
+{
+	php_phongo_cursor_t*   intern = Z_CURSOR_OBJ_P(getThis());
+	zval*                  zstream;
+	php_stream*            stream;
+	zend_string*           format = NULL;
+	php_phongo_json_mode_t mode   = PHONGO_JSON_MODE_LEGACY;
+	bool                   json   = false;
+	const bson_t*          doc;
+	smart_str              buf   = { 0 };
+	zend_long              count = 0;
+
+	PHONGO_PARSE_PARAMETERS_START(1, 2)
+	Z_PARAM_RESOURCE(zstream)
+	Z_PARAM_OPTIONAL
+	Z_PARAM_STR(format)
+	PHONGO_PARSE_PARAMETERS_END();
+
+	if (!(stream = (php_stream*) zend_fetch_resource2_ex(zstream, "stream", php_file_le_stream(), php_file_le_pstream()))) {
+		/* Exception already thrown */
 		return;
 	}
 
-	php_phongo_cursor_free_current(intern);
+	if (format && zend_string_equals_literal(format, "relaxed-json")) {
+		json = true;
+		mode = PHONGO_JSON_MODE_RELAXED;
+	} else if (format && zend_string_equals_literal(format, "canonical-json")) {
+		json = true;
+		mode = PHONGO_JSON_MODE_CANONICAL;
+	} else if (format && !zend_string_equals_literal(format, "bson")) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected format to be \"bson\", \"relaxed-json\", or \"canonical-json\", \"%s\" given", ZSTR_VAL(format));
+		return;
+	}
 
-	doc = mongoc_cursor_current(intern->cursor);
+	/* Start iteration if necessary, as foreach and toArray() would */
+	if (intern->current == 0 && !php_phongo_cursor_has_current(intern)) {
+		if (!php_phongo_cursor_rewind(intern, false)) {
+			/* Exception already thrown */
+			return;
+		}
+	}
 
-	if (doc) {
-		if (!php_phongo_bson_to_zval_ex(doc, &intern->visitor_data)) {
-			/* Free invalid result, but don't return as we want to free the
-			 * session if the intern is exhausted. */
-			php_phongo_cursor_free_current(intern);
+	doc = php_phongo_cursor_has_current(intern) ? mongoc_cursor_current(intern->cursor) : NULL;
+
+	while (doc) {
+		if (json) {
+			char*  json_str;
+			size_t json_len;
+
+			json_str = mode == PHONGO_JSON_MODE_RELAXED ? bson_as_relaxed_extended_json(doc, &json_len) : bson_as_canonical_extended_json(doc, &json_len);
+
+			if (!json_str) {
+				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Could not convert BSON document to a JSON string");
+				goto cleanup;
+			}
+
+			smart_str_appendl(&buf, json_str, json_len);
+			smart_str_appendc(&buf, '\n');
+			bson_free(json_str);
+		} else {
+			smart_str_appendl(&buf, (const char*) bson_get_data(doc), doc->len);
+		}
+
+		count++;
+
+		if (ZSTR_LEN(buf.s) >= PHONGO_CURSOR_WRITE_BUFFER_SIZE && !php_phongo_cursor_flush_buffer(stream, &buf)) {
+			goto cleanup;
 		}
+
+		doc = php_phongo_cursor_advance(intern, false);
+
+		if (EG(exception)) {
+			goto cleanup;
+		}
+	}
+
+	if (php_phongo_cursor_flush_buffer(stream, &buf)) {
+		RETVAL_LONG(count);
 	}
 
-	php_phongo_cursor_free_session_if_exhausted(intern);
+cleanup:
+	smart_str_free(&buf);
 }
 
 PHONGO_DISABLED_CONSTRUCTOR(MongoDB_Driver_Cursor)
@@ -314,6 +803,10 @@ static void php_phongo_cursor_free_object(zend_object* object)
 	 * active cursor owned by a parent process. */
 	PHONGO_RESET_CLIENT_IF_PID_DIFFERS(intern, Z_MANAGER_OBJ_P(&intern->manager));
 
+	/* Free the current result before destroying the libmongoc cursor, since it
+	 * may need to copy data from the cursor's current result. */
+	php_phongo_cursor_free_current(intern);
+
 	if (intern->cursor) {
 		mongoc_cursor_destroy(intern->cursor);
 	}
@@ -347,8 +840,6 @@ static void php_phongo_cursor_free_object(zend_object* object)
 	}
 
 	php_phongo_bson_typemap_dtor(&intern->visitor_data.map);
-
-	php_phongo_cursor_free_current(intern);
 }
 
 static zend_object* php_phongo_cursor_create_object(zend_class_entry* class_type)
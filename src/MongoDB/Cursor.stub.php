@@ -25,11 +25,20 @@ final class Cursor implements \Iterator, CursorInterface
 
     public function next(): void {}
 
+    final public function nextBatch(bool $raw = false): array|\MongoDB\BSON\PackedArray {}
+
     public function rewind(): void {}
 
+    final public function setAdaptiveBatchSize(int $targetBatchBytes, int $minBatchSize = 1, int $maxBatchSize = 2147483647): void {}
+
     final public function setTypeMap(array $typemap): void {}
 
     final public function toArray(): array {}
 
+    final public function toColumns(array $fieldPaths): array {}
+
     public function valid(): bool {}
+
+    /** @param resource $stream */
+    final public function writeTo($stream, string $format = 'bson'): int {}
 }
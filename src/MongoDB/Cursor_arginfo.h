@@ -1,5 +1,5 @@
 /* This is a generated file, edit the .stub.php file instead.
- * Stub hash: c2927c5d481f305b1579a8968eeecc39ba921ddd */
+ * Stub hash: 88192f9a30c25637773984cfd54fb3e80db3544e */
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_class_MongoDB_Driver_Cursor___construct, 0, 0, 0)
 ZEND_END_ARG_INFO()
@@ -23,8 +23,18 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_next, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_TYPE_MASK_EX(arginfo_class_MongoDB_Driver_Cursor_nextBatch, 0, 0, MongoDB\\BSON\\PackedArray, MAY_BE_ARRAY)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, raw, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
 #define arginfo_class_MongoDB_Driver_Cursor_rewind arginfo_class_MongoDB_Driver_Cursor_next
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_setAdaptiveBatchSize, 0, 1, IS_VOID, 0)
+	ZEND_ARG_TYPE_INFO(0, targetBatchBytes, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, minBatchSize, IS_LONG, 0, "1")
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxBatchSize, IS_LONG, 0, "2147483647")
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_setTypeMap, 0, 1, IS_VOID, 0)
 	ZEND_ARG_TYPE_INFO(0, typemap, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
@@ -32,8 +42,17 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_toArray, 0, 0, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_toColumns, 0, 1, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, fieldPaths, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 #define arginfo_class_MongoDB_Driver_Cursor_valid arginfo_class_MongoDB_Driver_Cursor_isDead
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_MongoDB_Driver_Cursor_writeTo, 0, 1, IS_LONG, 0)
+	ZEND_ARG_INFO(0, stream)
+	ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, format, IS_STRING, 0, "\'bson\'")
+ZEND_END_ARG_INFO()
+
 
 static ZEND_METHOD(MongoDB_Driver_Cursor, __construct);
 static ZEND_METHOD(MongoDB_Driver_Cursor, current);
@@ -42,10 +61,14 @@ static ZEND_METHOD(MongoDB_Driver_Cursor, getServer);
 static ZEND_METHOD(MongoDB_Driver_Cursor, isDead);
 static ZEND_METHOD(MongoDB_Driver_Cursor, key);
 static ZEND_METHOD(MongoDB_Driver_Cursor, next);
+static ZEND_METHOD(MongoDB_Driver_Cursor, nextBatch);
 static ZEND_METHOD(MongoDB_Driver_Cursor, rewind);
+static ZEND_METHOD(MongoDB_Driver_Cursor, setAdaptiveBatchSize);
 static ZEND_METHOD(MongoDB_Driver_Cursor, setTypeMap);
 static ZEND_METHOD(MongoDB_Driver_Cursor, toArray);
+static ZEND_METHOD(MongoDB_Driver_Cursor, toColumns);
 static ZEND_METHOD(MongoDB_Driver_Cursor, valid);
+static ZEND_METHOD(MongoDB_Driver_Cursor, writeTo);
 
 
 static const zend_function_entry class_MongoDB_Driver_Cursor_methods[] = {
@@ -56,10 +79,14 @@ static const zend_function_entry class_MongoDB_Driver_Cursor_methods[] = {
 	ZEND_ME(MongoDB_Driver_Cursor, isDead, arginfo_class_MongoDB_Driver_Cursor_isDead, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_ME(MongoDB_Driver_Cursor, key, arginfo_class_MongoDB_Driver_Cursor_key, ZEND_ACC_PUBLIC)
 	ZEND_ME(MongoDB_Driver_Cursor, next, arginfo_class_MongoDB_Driver_Cursor_next, ZEND_ACC_PUBLIC)
+	ZEND_ME(MongoDB_Driver_Cursor, nextBatch, arginfo_class_MongoDB_Driver_Cursor_nextBatch, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_ME(MongoDB_Driver_Cursor, rewind, arginfo_class_MongoDB_Driver_Cursor_rewind, ZEND_ACC_PUBLIC)
+	ZEND_ME(MongoDB_Driver_Cursor, setAdaptiveBatchSize, arginfo_class_MongoDB_Driver_Cursor_setAdaptiveBatchSize, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_ME(MongoDB_Driver_Cursor, setTypeMap, arginfo_class_MongoDB_Driver_Cursor_setTypeMap, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_ME(MongoDB_Driver_Cursor, toArray, arginfo_class_MongoDB_Driver_Cursor_toArray, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
+	ZEND_ME(MongoDB_Driver_Cursor, toColumns, arginfo_class_MongoDB_Driver_Cursor_toColumns, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_ME(MongoDB_Driver_Cursor, valid, arginfo_class_MongoDB_Driver_Cursor_valid, ZEND_ACC_PUBLIC)
+	ZEND_ME(MongoDB_Driver_Cursor, writeTo, arginfo_class_MongoDB_Driver_Cursor_writeTo, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL)
 	ZEND_FE_END
 };
 
@@ -17,6 +17,7 @@
 #include "bson/bson.h"
 
 #include <php.h>
+#include <ext/date/php_date.h>
 #include <Zend/zend_enum.h>
 #include <Zend/zend_interfaces.h>
 #include <Zend/zend_portability.h>
@@ -49,15 +50,22 @@
 #define PHONGO_TYPEMAP_FIELD_STR_ARRAY "array"
 #define PHONGO_TYPEMAP_FIELD_STR_DOCUMENT "document"
 #define PHONGO_TYPEMAP_FIELD_STR_ROOT "root"
+#define PHONGO_TYPEMAP_FIELD_STR_TYPES "types"
 
 #define PHONGO_TYPEMAP_TYPE_STR_ARRAY "array"
 #define PHONGO_TYPEMAP_TYPE_STR_BSON "bson"
 #define PHONGO_TYPEMAP_TYPE_STR_OBJECT "object"
 #define PHONGO_TYPEMAP_TYPE_STR_STDCLASS "stdclass"
+#define PHONGO_TYPEMAP_TYPE_STR_STRING "string"
+#define PHONGO_TYPEMAP_TYPE_STR_BINARY "binary"
+#define PHONGO_TYPEMAP_TYPE_STR_INT "int"
+#define PHONGO_TYPEMAP_TYPE_STR_DATETIMEIMMUTABLE "datetimeimmutable"
 
 /* Forward declarations */
-static bool php_phongo_bson_visit_document(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_document, void* data);
-static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_array, void* data);
+static bool php_phongo_bson_visit_document_in_document(const bson_iter_t* iter, const char* key, const bson_t* v_document, void* data);
+static bool php_phongo_bson_visit_document_in_array(const bson_iter_t* iter, const char* key, const bson_t* v_document, void* data);
+static bool php_phongo_bson_visit_array_in_document(const bson_iter_t* iter, const char* key, const bson_t* v_array, void* data);
+static bool php_phongo_bson_visit_array_in_array(const bson_iter_t* iter, const char* key, const bson_t* v_array, void* data);
 
 static inline bool phongo_is_class_instantiatable(const zend_class_entry* ce)
 {
@@ -216,7 +224,8 @@ static void php_phongo_bson_state_ctor(php_phongo_bson_state* state)
 
 static void php_phongo_bson_state_copy_ctor(php_phongo_bson_state* dst, php_phongo_bson_state* src)
 {
-	dst->map = src->map;
+	dst->map             = src->map;
+	dst->field_path_node = src->field_path_node;
 	if (src->field_path) {
 		src->field_path->ref_count++;
 	}
@@ -235,6 +244,53 @@ static void php_phongo_bson_state_dtor(php_phongo_bson_state* state)
 	}
 }
 
+/* Maximum number of distinct keys and maximum key length for the per-request
+ * cache of decoded document keys */
+#define PHONGO_BSON_KEY_CACHE_MAX_SIZE 1024
+#define PHONGO_BSON_KEY_CACHE_MAX_KEY_LEN 64
+
+/* Adds a value to the array being decoded under the given document key. The
+ * documents in a result set typically share a small number of keys, so keys
+ * are looked up in a per-request cache of pre-hashed strings instead of
+ * allocating and hashing a new string for every element. Like add_assoc_zval(),
+ * numeric keys are stored as integers and duplicate keys are overwritten. */
+static void php_phongo_bson_add_assoc(zval* retval, const char* key, zval* value)
+{
+	HashTable*   cache   = MONGODB_G(bson_keys);
+	size_t       key_len = strlen(key);
+	zend_ulong   index;
+	zval*        cached;
+	zend_string* zkey;
+
+	if (ZEND_HANDLE_NUMERIC_STR(key, key_len, index)) {
+		zend_hash_index_update(Z_ARRVAL_P(retval), index, value);
+		return;
+	}
+
+	if (!cache || key_len > PHONGO_BSON_KEY_CACHE_MAX_KEY_LEN) {
+		zend_hash_str_update(Z_ARRVAL_P(retval), key, key_len, value);
+		return;
+	}
+
+	if ((cached = zend_hash_str_find(cache, key, key_len))) {
+		zend_hash_update(Z_ARRVAL_P(retval), Z_STR_P(cached), value);
+		return;
+	}
+
+	zkey = zend_string_init(key, key_len, 0);
+	zend_string_hash_val(zkey);
+
+	if (zend_hash_num_elements(cache) < PHONGO_BSON_KEY_CACHE_MAX_SIZE) {
+		zval zcached;
+
+		ZVAL_STR_COPY(&zcached, zkey);
+		zend_hash_add_new(cache, zkey, &zcached);
+	}
+
+	zend_hash_update(Z_ARRVAL_P(retval), zkey, value);
+	zend_string_release(zkey);
+}
+
 static void php_phongo_bson_visit_corrupt(const bson_iter_t* iter ARG_UNUSED, void* data ARG_UNUSED)
 {
 	mongoc_log(MONGOC_LOG_LEVEL_WARNING, MONGOC_LOG_DOMAIN, "Corrupt BSON data detected!");
@@ -253,464 +309,570 @@ static void php_phongo_bson_visit_unsupported_type(const bson_iter_t* iter ARG_U
 	efree(path_string);
 }
 
-static bool php_phongo_bson_visit_double(const bson_iter_t* iter ARG_UNUSED, const char* key, double v_double, void* data)
+/* Returns the Persistable class named by a __pclass field, or NULL if the
+ * class does not exist or cannot be instantiated. Resolved classes are cached
+ * for the request, so documents sharing a __pclass only look it up once.
+ * Failed lookups are not cached, since the class may still be declared or
+ * become autoloadable later in the request. */
+static zend_class_entry* php_phongo_bson_fetch_odm_class(const char* class_name, size_t class_name_len)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	HashTable*        cache = MONGODB_G(odm_classes);
+	zend_string*      zs_classname;
+	zend_class_entry* found_ce;
+
+	if (cache && (found_ce = zend_hash_str_find_ptr(cache, class_name, class_name_len))) {
+		return found_ce;
+	}
+
+	zs_classname = zend_string_init(class_name, class_name_len, 0);
+	found_ce     = zend_fetch_class(zs_classname, ZEND_FETCH_CLASS_AUTO | ZEND_FETCH_CLASS_SILENT);
+	zend_string_release(zs_classname);
+
+	if (!found_ce || !phongo_is_class_instantiatable(found_ce) || !instanceof_function(found_ce, php_phongo_persistable_ce)) {
+		return NULL;
+	}
+
+	if (cache) {
+		zend_hash_str_add_new_ptr(cache, class_name, class_name_len, found_ce);
+	}
+
+	return found_ce;
+}
 
-	if (state->is_visiting_array) {
-		add_next_index_double(retval, v_double);
+/* Adds a decoded element to the array being built for the current document or
+ * array. Element visitors are defined once per context (see
+ * PHONGO_BSON_DEFINE_VISITORS), so is_array is a constant in each of them and
+ * this branch is resolved at compile time. */
+static zend_always_inline void php_phongo_bson_add(zval* retval, bool is_array, const char* key, zval* value)
+{
+	if (is_array) {
+		zend_hash_next_index_insert(Z_ARRVAL_P(retval), value);
 	} else {
-		add_assoc_double(retval, key, v_double);
+		php_phongo_bson_add_assoc(retval, key, value);
 	}
+}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+/* Returns the fieldPaths node for the given key within the compound type
+ * described by the parent node. Since the trie was compiled with wildcard
+ * paths merged into explicit keys, this requires at most one lookup per
+ * nesting level. NULL is returned if no fieldPaths entry can match. */
+static php_phongo_field_path_node* php_phongo_field_path_node_find_child(php_phongo_field_path_node* node, const char* key)
+{
+	php_phongo_field_path_node* child;
 
-	return false;
+	if (!node) {
+		return NULL;
+	}
+
+	if (node->children && (child = zend_hash_str_find_ptr(node->children, key, strlen(key)))) {
+		return child;
+	}
+
+	return node->wildcard;
 }
 
-static bool php_phongo_bson_visit_utf8(const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_utf8_len, const char* v_utf8, void* data)
+/* Returns the scalar coercion specified by a "types" fieldPaths entry for the
+ * given key, or PHONGO_TYPEMAP_NONE if there is none. Callers should fall back to the
+ * default in the "types" type map if the coercion does not apply to the BSON
+ * type being decoded. */
+static zend_always_inline php_phongo_bson_typemap_types php_phongo_bson_state_scalar_type(php_phongo_bson_state* state, const char* key)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	php_phongo_field_path_node* node;
 
-	if (state->is_visiting_array) {
-		ADD_NEXT_INDEX_STRINGL(retval, v_utf8, v_utf8_len);
-	} else {
-		ADD_ASSOC_STRING_EX(retval, key, strlen(key), v_utf8, v_utf8_len);
+	if (!state->field_path_node) {
+		return PHONGO_TYPEMAP_NONE;
 	}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	node = php_phongo_field_path_node_find_child(state->field_path_node, key);
+
+	return node ? node->scalar_type : PHONGO_TYPEMAP_NONE;
+}
+
+/* Defines the document and array variants of an element visitor, which call
+ * php_phongo_bson_visit_<name>() with is_array set accordingly. The variants
+ * are referenced by php_bson_visitors_document and php_bson_visitors_array. */
+#define PHONGO_BSON_DEFINE_VISITORS(name, params, ...)              \
+	static bool php_phongo_bson_visit_##name##_in_document params   \
+	{                                                               \
+		return php_phongo_bson_visit_##name(false, __VA_ARGS__);    \
+	}                                                               \
+	static bool php_phongo_bson_visit_##name##_in_array params      \
+	{                                                               \
+		return php_phongo_bson_visit_##name(true, __VA_ARGS__);     \
+	}
+
+static zend_always_inline bool php_phongo_bson_visit_double(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, double v_double, void* data)
+{
+	zval zchild;
+
+	ZVAL_DOUBLE(&zchild, v_double);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(double, (const bson_iter_t* iter, const char* key, double v_double, void* data), iter, key, v_double, data)
 
-static bool php_phongo_bson_visit_binary(const bson_iter_t* iter ARG_UNUSED, const char* key, bson_subtype_t v_subtype, size_t v_binary_len, const uint8_t* v_binary, void* data)
+static zend_always_inline bool php_phongo_bson_visit_utf8(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_utf8_len, const char* v_utf8, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	zval zchild;
+
+	ZVAL_STRINGL(&zchild, v_utf8, v_utf8_len);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
+
+	return false;
+}
+PHONGO_BSON_DEFINE_VISITORS(utf8, (const bson_iter_t* iter, const char* key, size_t v_utf8_len, const char* v_utf8, void* data), iter, key, v_utf8_len, v_utf8, data)
+
+static zend_always_inline bool php_phongo_bson_visit_binary(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, bson_subtype_t v_subtype, size_t v_binary_len, const uint8_t* v_binary, void* data)
+{
+	zval zchild;
 
 	if (v_subtype == 0x80 && strcmp(key, PHONGO_ODM_FIELD_NAME) == 0) {
-		zend_string*      zs_classname = zend_string_init((const char*) v_binary, v_binary_len, 0);
-		zend_class_entry* found_ce     = zend_fetch_class(zs_classname, ZEND_FETCH_CLASS_AUTO | ZEND_FETCH_CLASS_SILENT);
-		zend_string_release(zs_classname);
+		zend_class_entry* found_ce = php_phongo_bson_fetch_odm_class((const char*) v_binary, v_binary_len);
 
-		if (found_ce && phongo_is_class_instantiatable(found_ce) && instanceof_function(found_ce, php_phongo_persistable_ce)) {
+		if (found_ce) {
 			((php_phongo_bson_state*) data)->odm_ce = found_ce;
 		}
 	}
 
-	{
-		zval zchild;
-
-		if (!phongo_binary_new(&zchild, (const char*) v_binary, v_binary_len, v_subtype)) {
-			return true;
-		}
-
-		if (state->is_visiting_array) {
-			add_next_index_zval(retval, &zchild);
-		} else {
-			ADD_ASSOC_ZVAL(retval, key, &zchild);
-		}
+	if (!phongo_binary_new(&zchild, (const char*) v_binary, v_binary_len, v_subtype)) {
+		return true;
 	}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(binary, (const bson_iter_t* iter, const char* key, bson_subtype_t v_subtype, size_t v_binary_len, const uint8_t* v_binary, void* data), iter, key, v_subtype, v_binary_len, v_binary, data)
 
-static bool php_phongo_bson_visit_undefined(const bson_iter_t* iter, const char* key, void* data)
+static zend_always_inline bool php_phongo_bson_visit_undefined(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	object_init_ex(&zchild, php_phongo_undefined_ce);
-
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(undefined, (const bson_iter_t* iter, const char* key, void* data), iter, key, data)
 
-static bool php_phongo_bson_visit_oid(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_oid_t* v_oid, void* data)
+static zend_always_inline bool php_phongo_bson_visit_oid(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_oid_t* v_oid, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	php_phongo_bson_state*        state = (php_phongo_bson_state*) data;
+	php_phongo_bson_typemap_types type  = php_phongo_bson_state_scalar_type(state, key);
+	zval                          zchild;
 
-	if (!phongo_objectid_new(&zchild, v_oid)) {
-		return true;
+	if (type != PHONGO_TYPEMAP_NATIVE_STRING && type != PHONGO_TYPEMAP_NATIVE_BINARY) {
+		type = state->map.types.objectid;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
+	if (type == PHONGO_TYPEMAP_NATIVE_STRING) {
+		char oid_str[25];
+
+		bson_oid_to_string(v_oid, oid_str);
+		ZVAL_STRINGL(&zchild, oid_str, 24);
+	} else if (type == PHONGO_TYPEMAP_NATIVE_BINARY) {
+		ZVAL_STRINGL(&zchild, (const char*) v_oid->bytes, sizeof(v_oid->bytes));
+	} else if (!phongo_objectid_new(&zchild, v_oid)) {
+		return true;
 	}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(oid, (const bson_iter_t* iter, const char* key, const bson_oid_t* v_oid, void* data), iter, key, v_oid, data)
 
-static bool php_phongo_bson_visit_bool(const bson_iter_t* iter ARG_UNUSED, const char* key, bool v_bool, void* data)
+static zend_always_inline bool php_phongo_bson_visit_bool(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, bool v_bool, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	zval zchild;
 
-	if (state->is_visiting_array) {
-		add_next_index_bool(retval, v_bool);
-	} else {
-		add_assoc_bool(retval, key, v_bool);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	ZVAL_BOOL(&zchild, v_bool);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(bool, (const bson_iter_t* iter, const char* key, bool v_bool, void* data), iter, key, v_bool, data)
 
-static bool php_phongo_bson_visit_date_time(const bson_iter_t* iter ARG_UNUSED, const char* key, int64_t msec_since_epoch, void* data)
+static zend_always_inline bool php_phongo_bson_visit_date_time(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, int64_t msec_since_epoch, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	php_phongo_bson_state*        state = (php_phongo_bson_state*) data;
+	php_phongo_bson_typemap_types type  = php_phongo_bson_state_scalar_type(state, key);
+	zval                          zchild;
 
-	if (!phongo_utcdatetime_new(&zchild, msec_since_epoch)) {
-		return true;
+	if (type != PHONGO_TYPEMAP_NATIVE_INT && type != PHONGO_TYPEMAP_DATETIMEIMMUTABLE) {
+		type = state->map.types.utcdatetime;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
+	if (type == PHONGO_TYPEMAP_NATIVE_INT) {
+		ZVAL_INT64(&zchild, msec_since_epoch);
+	} else if (type == PHONGO_TYPEMAP_DATETIMEIMMUTABLE) {
+		phongo_utcdatetime_to_php_date(&zchild, msec_since_epoch, php_date_get_immutable_ce());
+	} else if (!phongo_utcdatetime_new(&zchild, msec_since_epoch)) {
+		return true;
 	}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(date_time, (const bson_iter_t* iter, const char* key, int64_t msec_since_epoch, void* data), iter, key, msec_since_epoch, data)
 
-static bool php_phongo_bson_visit_decimal128(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_decimal128_t* decimal, void* data)
+static zend_always_inline bool php_phongo_bson_visit_decimal128(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_decimal128_t* decimal, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	php_phongo_bson_state*        state = (php_phongo_bson_state*) data;
+	php_phongo_bson_typemap_types type  = php_phongo_bson_state_scalar_type(state, key);
+	zval                          zchild;
 
-	if (!phongo_decimal128_new(&zchild, decimal)) {
-		return true;
+	if (type != PHONGO_TYPEMAP_NATIVE_STRING) {
+		type = state->map.types.decimal128;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
+	if (type == PHONGO_TYPEMAP_NATIVE_STRING) {
+		char decimal_str[BSON_DECIMAL128_STRING];
+
+		bson_decimal128_to_string(decimal, decimal_str);
+		ZVAL_STRING(&zchild, decimal_str);
+	} else if (!phongo_decimal128_new(&zchild, decimal)) {
+		return true;
 	}
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(decimal128, (const bson_iter_t* iter, const char* key, const bson_decimal128_t* decimal, void* data), iter, key, decimal, data)
 
-static bool php_phongo_bson_visit_null(const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
+static zend_always_inline bool php_phongo_bson_visit_null(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-
-	if (state->is_visiting_array) {
-		add_next_index_null(retval);
-	} else {
-		add_assoc_null(retval, key);
-	}
+	zval zchild;
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	ZVAL_NULL(&zchild);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(null, (const bson_iter_t* iter, const char* key, void* data), iter, key, data)
 
-static bool php_phongo_bson_visit_regex(const bson_iter_t* iter ARG_UNUSED, const char* key, const char* v_regex, const char* v_options, void* data)
+static zend_always_inline bool php_phongo_bson_visit_regex(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, const char* v_regex, const char* v_options, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_regex_new(&zchild, v_regex, v_options)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(regex, (const bson_iter_t* iter, const char* key, const char* v_regex, const char* v_options, void* data), iter, key, v_regex, v_options, data)
 
-static bool php_phongo_bson_visit_symbol(const bson_iter_t* iter, const char* key, size_t v_symbol_len, const char* v_symbol, void* data)
+static zend_always_inline bool php_phongo_bson_visit_symbol(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_symbol_len, const char* v_symbol, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_symbol_new(&zchild, v_symbol, v_symbol_len)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(symbol, (const bson_iter_t* iter, const char* key, size_t v_symbol_len, const char* v_symbol, void* data), iter, key, v_symbol_len, v_symbol, data)
 
-static bool php_phongo_bson_visit_code(const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_code_len, const char* v_code, void* data)
+static zend_always_inline bool php_phongo_bson_visit_code(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_code_len, const char* v_code, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_javascript_new(&zchild, v_code, v_code_len, NULL)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(code, (const bson_iter_t* iter, const char* key, size_t v_code_len, const char* v_code, void* data), iter, key, v_code_len, v_code, data)
 
-static bool php_phongo_bson_visit_dbpointer(const bson_iter_t* iter, const char* key, size_t namespace_len, const char* namespace, const bson_oid_t* oid, void* data)
+static zend_always_inline bool php_phongo_bson_visit_dbpointer(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, size_t namespace_len, const char* namespace, const bson_oid_t* oid, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_dbpointer_new(&zchild, namespace, namespace_len, oid)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(dbpointer, (const bson_iter_t* iter, const char* key, size_t namespace_len, const char* namespace, const bson_oid_t* oid, void* data), iter, key, namespace_len, namespace, oid, data)
 
-static bool php_phongo_bson_visit_codewscope(const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_code_len, const char* v_code, const bson_t* v_scope, void* data)
+static zend_always_inline bool php_phongo_bson_visit_codewscope(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, size_t v_code_len, const char* v_code, const bson_t* v_scope, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_javascript_new(&zchild, v_code, v_code_len, v_scope)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(codewscope, (const bson_iter_t* iter, const char* key, size_t v_code_len, const char* v_code, const bson_t* v_scope, void* data), iter, key, v_code_len, v_code, v_scope, data)
 
-static bool php_phongo_bson_visit_int32(const bson_iter_t* iter ARG_UNUSED, const char* key, int32_t v_int32, void* data)
+static zend_always_inline bool php_phongo_bson_visit_int32(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, int32_t v_int32, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	zval zchild;
 
-	if (state->is_visiting_array) {
-		add_next_index_long(retval, v_int32);
-	} else {
-		add_assoc_long(retval, key, v_int32);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	ZVAL_LONG(&zchild, v_int32);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(int32, (const bson_iter_t* iter, const char* key, int32_t v_int32, void* data), iter, key, v_int32, data)
 
-static bool php_phongo_bson_visit_timestamp(const bson_iter_t* iter ARG_UNUSED, const char* key, uint32_t v_timestamp, uint32_t v_increment, void* data)
+static zend_always_inline bool php_phongo_bson_visit_timestamp(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, uint32_t v_timestamp, uint32_t v_increment, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	if (!phongo_timestamp_new(&zchild, v_increment, v_timestamp)) {
 		return true;
 	}
 
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(timestamp, (const bson_iter_t* iter, const char* key, uint32_t v_timestamp, uint32_t v_increment, void* data), iter, key, v_timestamp, v_increment, data)
 
-static bool php_phongo_bson_visit_int64(const bson_iter_t* iter ARG_UNUSED, const char* key, int64_t v_int64, void* data)
+static zend_always_inline bool php_phongo_bson_visit_int64(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, int64_t v_int64, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
+	php_phongo_bson_state*        state = (php_phongo_bson_state*) data;
+	php_phongo_bson_typemap_types type  = php_phongo_bson_state_scalar_type(state, key);
+	zval                          zchild;
 
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	if (type != PHONGO_TYPEMAP_NATIVE_INT) {
+		type = state->map.types.int64;
+	}
 
-	if (state->is_visiting_array) {
-		if (state->map.int64_as_object) {
-			ADD_NEXT_INDEX_INT64_OBJ(retval, v_int64);
-		} else {
-			ADD_NEXT_INDEX_INT64(retval, v_int64);
-		}
+	/* An explicit "int" coercion takes precedence over int64_as_object, which
+	 * Document::toPHP() and PackedArray::toPHP() enable by default */
+	if (type == PHONGO_TYPEMAP_BSON || (type != PHONGO_TYPEMAP_NATIVE_INT && state->map.int64_as_object)) {
+		phongo_int64_new(&zchild, v_int64);
 	} else {
-		if (state->map.int64_as_object) {
-			ADD_ASSOC_INT64_OBJ(retval, key, v_int64);
-		} else {
-			ADD_ASSOC_INT64(retval, key, v_int64);
-		}
+		ZVAL_INT64(&zchild, v_int64);
 	}
 
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
+
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(int64, (const bson_iter_t* iter, const char* key, int64_t v_int64, void* data), iter, key, v_int64, data)
 
-static bool php_phongo_bson_visit_maxkey(const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
+static zend_always_inline bool php_phongo_bson_visit_maxkey(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	object_init_ex(&zchild, php_phongo_maxkey_ce);
-
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(maxkey, (const bson_iter_t* iter, const char* key, void* data), iter, key, data)
 
-static bool php_phongo_bson_visit_minkey(const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
+static zend_always_inline bool php_phongo_bson_visit_minkey(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, void* data)
 {
-	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
-	php_phongo_bson_state* state  = (php_phongo_bson_state*) data;
-	zval                   zchild;
+	zval zchild;
 
 	object_init_ex(&zchild, php_phongo_minkey_ce);
-
-	if (state->is_visiting_array) {
-		add_next_index_zval(retval, &zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &zchild);
-	}
-
-	php_phongo_field_path_write_item_at_current_level(state->field_path, key);
+	php_phongo_bson_add(PHONGO_BSON_STATE_ZCHILD(data), is_array, key, &zchild);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(minkey, (const bson_iter_t* iter, const char* key, void* data), iter, key, data)
+
+/* Visitors for the elements of a document, which are added to the PHP array by
+ * key, and of an array, which are appended. Elements do not update the field
+ * path, which is only used for error messages: nested documents and arrays
+ * push their key, and php_phongo_bson_visit_unsupported_type() writes the key
+ * of the offending element before reporting it. */
+static const bson_visitor_t php_bson_visitors_document = {
+	NULL /* php_phongo_bson_visit_before*/,
+	NULL /*php_phongo_bson_visit_after*/,
+	php_phongo_bson_visit_corrupt,
+	php_phongo_bson_visit_double_in_document,
+	php_phongo_bson_visit_utf8_in_document,
+	php_phongo_bson_visit_document_in_document,
+	php_phongo_bson_visit_array_in_document,
+	php_phongo_bson_visit_binary_in_document,
+	php_phongo_bson_visit_undefined_in_document,
+	php_phongo_bson_visit_oid_in_document,
+	php_phongo_bson_visit_bool_in_document,
+	php_phongo_bson_visit_date_time_in_document,
+	php_phongo_bson_visit_null_in_document,
+	php_phongo_bson_visit_regex_in_document,
+	php_phongo_bson_visit_dbpointer_in_document,
+	php_phongo_bson_visit_code_in_document,
+	php_phongo_bson_visit_symbol_in_document,
+	php_phongo_bson_visit_codewscope_in_document,
+	php_phongo_bson_visit_int32_in_document,
+	php_phongo_bson_visit_timestamp_in_document,
+	php_phongo_bson_visit_int64_in_document,
+	php_phongo_bson_visit_maxkey_in_document,
+	php_phongo_bson_visit_minkey_in_document,
+	php_phongo_bson_visit_unsupported_type,
+	php_phongo_bson_visit_decimal128_in_document,
+	{ NULL }
+};
 
-static const bson_visitor_t php_bson_visitors = {
+static const bson_visitor_t php_bson_visitors_array = {
 	NULL /* php_phongo_bson_visit_before*/,
 	NULL /*php_phongo_bson_visit_after*/,
 	php_phongo_bson_visit_corrupt,
-	php_phongo_bson_visit_double,
-	php_phongo_bson_visit_utf8,
-	php_phongo_bson_visit_document,
-	php_phongo_bson_visit_array,
-	php_phongo_bson_visit_binary,
-	php_phongo_bson_visit_undefined,
-	php_phongo_bson_visit_oid,
-	php_phongo_bson_visit_bool,
-	php_phongo_bson_visit_date_time,
-	php_phongo_bson_visit_null,
-	php_phongo_bson_visit_regex,
-	php_phongo_bson_visit_dbpointer,
-	php_phongo_bson_visit_code,
-	php_phongo_bson_visit_symbol,
-	php_phongo_bson_visit_codewscope,
-	php_phongo_bson_visit_int32,
-	php_phongo_bson_visit_timestamp,
-	php_phongo_bson_visit_int64,
-	php_phongo_bson_visit_maxkey,
-	php_phongo_bson_visit_minkey,
+	php_phongo_bson_visit_double_in_array,
+	php_phongo_bson_visit_utf8_in_array,
+	php_phongo_bson_visit_document_in_array,
+	php_phongo_bson_visit_array_in_array,
+	php_phongo_bson_visit_binary_in_array,
+	php_phongo_bson_visit_undefined_in_array,
+	php_phongo_bson_visit_oid_in_array,
+	php_phongo_bson_visit_bool_in_array,
+	php_phongo_bson_visit_date_time_in_array,
+	php_phongo_bson_visit_null_in_array,
+	php_phongo_bson_visit_regex_in_array,
+	php_phongo_bson_visit_dbpointer_in_array,
+	php_phongo_bson_visit_code_in_array,
+	php_phongo_bson_visit_symbol_in_array,
+	php_phongo_bson_visit_codewscope_in_array,
+	php_phongo_bson_visit_int32_in_array,
+	php_phongo_bson_visit_timestamp_in_array,
+	php_phongo_bson_visit_int64_in_array,
+	php_phongo_bson_visit_maxkey_in_array,
+	php_phongo_bson_visit_minkey_in_array,
 	php_phongo_bson_visit_unsupported_type,
-	php_phongo_bson_visit_decimal128,
+	php_phongo_bson_visit_decimal128_in_array,
 	{ NULL }
 };
 
-static inline bool map_element_matches_field_path(php_phongo_field_path_map_element* map_element, php_phongo_field_path* current)
+static void php_phongo_handle_field_path_entry_for_compound_type(php_phongo_bson_state* state, const char* key, php_phongo_bson_typemap_element* element)
 {
-	size_t i;
+	php_phongo_field_path_node* node = php_phongo_field_path_node_find_child(state->field_path_node, key);
 
-	if (map_element->entry->size != current->size) {
+	state->field_path_node = node;
+
+	if (node && node->has_type) {
+		state->field_type.type = node->type.type;
+		state->field_type.ce   = node->type.ce;
+	} else {
+		state->field_type.type = element->type;
+		state->field_type.ce   = element->ce;
+	}
+}
+
+/* Returns whether a declared property can be initialized by writing its slot
+ * directly. Static and readonly properties, as well as virtual and hooked
+ * properties on PHP 8.4+, must be assigned through the object handlers. */
+static bool php_phongo_bson_property_has_plain_slot(const zend_property_info* prop_info)
+{
+	if (prop_info->flags & (ZEND_ACC_STATIC | ZEND_ACC_READONLY)) {
 		return false;
 	}
-	for (i = 0; i < current->size; i++) {
-		if (strcmp(map_element->entry->elements[i], "$") == 0) {
-			continue;
-		}
-		if (strcmp(map_element->entry->elements[i], current->elements[i]) != 0) {
-			return false;
-		}
+
+#if PHP_VERSION_ID >= 80400
+	if (prop_info->flags & ZEND_ACC_VIRTUAL || prop_info->hooks) {
+		return false;
 	}
+#endif
+
 	return true;
 }
 
-static php_phongo_field_path_map_element* map_find_field_path_entry(php_phongo_bson_state* state)
+/* Writes the fields of a decoded document to the properties of an object.
+ * Values for declared properties with a plain slot are stored directly in that
+ * slot, subject to the same coercion and type checks as an assignment. Other
+ * fields are assigned through the object handlers, except for an undeclared
+ * __pclass field. Returns false if an exception was thrown. */
+static bool php_phongo_bson_hydrate_object(zend_object* object, HashTable* fields)
 {
-	size_t i;
+	zend_string* string_key;
+	zend_ulong   num_key;
+	zval*        value;
+
+	ZEND_HASH_FOREACH_KEY_VAL(fields, num_key, string_key, value)
+	{
+		zend_string*        name = string_key ? zend_string_copy(string_key) : zend_long_to_str(num_key);
+		zend_property_info* prop_info;
+		zval*               slot;
+		zval                tmp;
+
+		prop_info = zend_hash_find_ptr(&object->ce->properties_info, name);
+
+		if (!prop_info || !php_phongo_bson_property_has_plain_slot(prop_info)) {
+			if (prop_info || !zend_string_equals_literal(name, PHONGO_ODM_FIELD_NAME)) {
+				zend_update_property_ex(prop_info ? prop_info->ce : object->ce, object, name, value);
+			}
 
-	/* Loop over all field path mappings, and for each, try to see whether it matches the current path */
-	for (i = 0; i < state->map.field_paths.size; i++) {
-		if (map_element_matches_field_path(state->map.field_paths.map[i], state->field_path)) {
-			return state->map.field_paths.map[i];
+			zend_string_release(name);
+
+			if (EG(exception)) {
+				return false;
+			}
+
+			continue;
 		}
+
+		zend_string_release(name);
+
+		ZVAL_COPY(&tmp, value);
+
+		if (ZEND_TYPE_IS_SET(prop_info->type) && !zend_verify_property_type(prop_info, &tmp, false)) {
+			/* Exception already thrown */
+			zval_ptr_dtor(&tmp);
+			return false;
+		}
+
+		slot = OBJ_PROP(object, prop_info->offset);
+		zval_ptr_dtor(slot);
+		ZVAL_COPY_VALUE(slot, &tmp);
+		Z_PROP_FLAG_P(slot) &= ~IS_PROP_UNINIT;
 	}
-	return NULL;
+	ZEND_HASH_FOREACH_END();
+
+	return true;
 }
 
-static void php_phongo_handle_field_path_entry_for_compound_type(php_phongo_bson_state* state, php_phongo_bson_typemap_element* element)
+/* Replaces a decoded document with an instance of the given class. Classes
+ * implementing MongoDB\BSON\Hydratable have their properties initialized from
+ * the document directly; otherwise, the document is passed to bsonUnserialize().
+ * If hydrating the object fails, the partially initialized object is freed, the
+ * document is left as-is, and false is returned. */
+static bool php_phongo_bson_unserialize_object(zend_class_entry* ce, zval* zchild)
 {
-	php_phongo_field_path_map_element* entry = map_find_field_path_entry(state);
+	zval obj;
+
+	object_init_ex(&obj, ce);
 
-	if (entry) {
-		state->field_type.type = entry->node.type;
-		state->field_type.ce   = entry->node.ce;
+	if (instanceof_function(ce, php_phongo_hydratable_ce)) {
+		if (!php_phongo_bson_hydrate_object(Z_OBJ(obj), Z_ARRVAL_P(zchild))) {
+			/* Exception already thrown */
+			zval_ptr_dtor(&obj);
+			return false;
+		}
 	} else {
-		state->field_type.type = element->type;
-		state->field_type.ce   = element->ce;
+		zend_call_method_with_1_params(Z_OBJ(obj), NULL, NULL, BSON_UNSERIALIZE_FUNC_NAME, NULL, zchild);
 	}
+
+	zval_ptr_dtor(zchild);
+	ZVAL_COPY_VALUE(zchild, &obj);
+
+	return true;
 }
 
-static bool php_phongo_bson_visit_document(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_document, void* data)
+static zend_always_inline bool php_phongo_bson_visit_document(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_document, void* data)
 {
 	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
 	bson_iter_t            child;
@@ -724,7 +886,7 @@ static bool php_phongo_bson_visit_document(const bson_iter_t* iter ARG_UNUSED, c
 
 	/* Check for entries in the fieldPath type map key, and use them to
 	 * override the default ones for this type */
-	php_phongo_handle_field_path_entry_for_compound_type(&state, &state.map.document);
+	php_phongo_handle_field_path_entry_for_compound_type(&state, key, &state.map.document);
 
 	/* Only traverse BSON document if we're not returning a raw BSON structure */
 	if (state.field_type.type != PHONGO_TYPEMAP_BSON) {
@@ -735,7 +897,7 @@ static bool php_phongo_bson_visit_document(const bson_iter_t* iter ARG_UNUSED, c
 
 		array_init(&state.zchild);
 
-		if (bson_iter_visit_all(&child, &php_bson_visitors, &state) || child.err_off) {
+		if (bson_iter_visit_all(&child, &php_bson_visitors_document, &state) || child.err_off) {
 			/* Iteration stopped prematurely due to corruption or a failed
 			 * visitor. Free state.zchild, which we just initialized, and return
 			 * true to stop iteration for our parent context. */
@@ -766,37 +928,31 @@ static bool php_phongo_bson_visit_document(const bson_iter_t* iter ARG_UNUSED, c
 			/* Do nothing, item will be added later */
 			break;
 
-		case PHONGO_TYPEMAP_CLASS: {
-			zval              obj;
-			zend_class_entry* obj_ce = state.odm_ce ? state.odm_ce : state.field_type.ce;
-
-			object_init_ex(&obj, obj_ce);
-
-			zend_call_method_with_1_params(Z_OBJ_P(&obj), NULL, NULL, BSON_UNSERIALIZE_FUNC_NAME, NULL, &state.zchild);
-			zval_ptr_dtor(&state.zchild);
-			ZVAL_COPY_VALUE(&state.zchild, &obj);
-
+		case PHONGO_TYPEMAP_CLASS:
+			if (!php_phongo_bson_unserialize_object(state.odm_ce ? state.odm_ce : state.field_type.ce, &state.zchild)) {
+				/* Exception already thrown. Free state.zchild and return true
+				 * to stop iteration for our parent context. */
+				zval_ptr_dtor(&state.zchild);
+				php_phongo_bson_state_dtor(&state);
+				return true;
+			}
 			break;
-		}
 
 		case PHONGO_TYPEMAP_NATIVE_OBJECT:
 		default:
 			convert_to_object(&state.zchild);
 	}
 
-	if (parent_state->is_visiting_array) {
-		add_next_index_zval(retval, &state.zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &state.zchild);
-	}
+	php_phongo_bson_add(retval, is_array, key, &state.zchild);
 
 	php_phongo_bson_state_dtor(&state);
 	php_phongo_field_path_pop(parent_state->field_path);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(document, (const bson_iter_t* iter, const char* key, const bson_t* v_document, void* data), iter, key, v_document, data)
 
-static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_array, void* data)
+static zend_always_inline bool php_phongo_bson_visit_array(bool is_array, const bson_iter_t* iter ARG_UNUSED, const char* key, const bson_t* v_array, void* data)
 {
 	zval*                  retval = PHONGO_BSON_STATE_ZCHILD(data);
 	bson_iter_t            child;
@@ -810,7 +966,7 @@ static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, cons
 
 	/* Check for entries in the fieldPath type map key, and use them to
 	 * override the default ones for this type */
-	php_phongo_handle_field_path_entry_for_compound_type(&state, &state.map.array);
+	php_phongo_handle_field_path_entry_for_compound_type(&state, key, &state.map.array);
 
 	/* Only traverse BSON array if we're not returning a raw BSON structure */
 	if (state.field_type.type != PHONGO_TYPEMAP_BSON) {
@@ -819,15 +975,11 @@ static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, cons
 			return false;
 		}
 
-		/* Note that we are visiting an array, so element visitors know to use
-		 * add_next_index() (i.e. disregard BSON keys) instead of add_assoc()
-		 * when building the PHP array.
-		 */
-		state.is_visiting_array = true;
-
+		/* Elements are visited with the array visitors, which disregard BSON
+		 * keys and append to the PHP array. */
 		array_init(&state.zchild);
 
-		if (bson_iter_visit_all(&child, &php_bson_visitors, &state) || child.err_off) {
+		if (bson_iter_visit_all(&child, &php_bson_visitors_array, &state) || child.err_off) {
 			/* Iteration stopped prematurely due to corruption or a failed
 			 * visitor. Free state.zchild, which we just initialized, and return
 			 * true to stop iteration for our parent context. */
@@ -848,15 +1000,15 @@ static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, cons
 			break;
 		}
 
-		case PHONGO_TYPEMAP_CLASS: {
-			zval obj;
-
-			object_init_ex(&obj, state.field_type.ce);
-			zend_call_method_with_1_params(Z_OBJ_P(&obj), NULL, NULL, BSON_UNSERIALIZE_FUNC_NAME, NULL, &state.zchild);
-			zval_ptr_dtor(&state.zchild);
-			ZVAL_COPY_VALUE(&state.zchild, &obj);
+		case PHONGO_TYPEMAP_CLASS:
+			if (!php_phongo_bson_unserialize_object(state.field_type.ce, &state.zchild)) {
+				/* Exception already thrown. Free state.zchild and return true
+				 * to stop iteration for our parent context. */
+				zval_ptr_dtor(&state.zchild);
+				php_phongo_bson_state_dtor(&state);
+				return true;
+			}
 			break;
-		}
 
 		case PHONGO_TYPEMAP_NATIVE_OBJECT:
 			convert_to_object(&state.zchild);
@@ -868,17 +1020,14 @@ static bool php_phongo_bson_visit_array(const bson_iter_t* iter ARG_UNUSED, cons
 			break;
 	}
 
-	if (parent_state->is_visiting_array) {
-		add_next_index_zval(retval, &state.zchild);
-	} else {
-		ADD_ASSOC_ZVAL(retval, key, &state.zchild);
-	}
+	php_phongo_bson_add(retval, is_array, key, &state.zchild);
 
 	php_phongo_bson_state_dtor(&state);
 	php_phongo_field_path_pop(parent_state->field_path);
 
 	return false;
 }
+PHONGO_BSON_DEFINE_VISITORS(array, (const bson_iter_t* iter, const char* key, const bson_t* v_array, void* data), iter, key, v_array, data)
 
 /* Converts a BSON document to a PHP value using the default typemap. */
 bool php_phongo_bson_to_zval(const bson_t* b, zval* zv)
@@ -1101,12 +1250,16 @@ bool php_phongo_bson_to_zval_ex(const bson_t* b, php_phongo_bson_state* state)
 		goto cleanup;
 	}
 
+	/* Field path lookups for nested documents and arrays start at the root of
+	 * the compiled fieldPaths trie */
+	state->field_path_node = state->map.field_paths ? state->map.field_paths->trie : NULL;
+
 	/* We initialize an array because it will either be returned as-is (native
 	 * array in type map), passed to bsonUnserialize() (ODM class), or used to
 	 * initialize a stdClass object (native object in type map). */
 	array_init(&state->zchild);
 
-	if (bson_iter_visit_all(&iter, &php_bson_visitors, state) || iter.err_off) {
+	if (bson_iter_visit_all(&iter, state->is_visiting_array ? &php_bson_visitors_array : &php_bson_visitors_document, state) || iter.err_off) {
 		/* Iteration stopped prematurely due to corruption or a failed visitor.
 		 * While we free the reader, state->zchild should be left as-is, since
 		 * the calling code may want to zval_ptr_dtor() it. If an exception has
@@ -1137,18 +1290,12 @@ bool php_phongo_bson_to_zval_ex(const bson_t* b, php_phongo_bson_state* state)
 			/* Nothing to do here */
 			break;
 
-		case PHONGO_TYPEMAP_CLASS: {
-			zval              obj;
-			zend_class_entry* obj_ce = state->odm_ce ? state->odm_ce : state->map.root.ce;
-
-			object_init_ex(&obj, obj_ce);
-
-			zend_call_method_with_1_params(Z_OBJ_P(&obj), NULL, NULL, BSON_UNSERIALIZE_FUNC_NAME, NULL, &state->zchild);
-			zval_ptr_dtor(&state->zchild);
-			ZVAL_COPY_VALUE(&state->zchild, &obj);
-
+		case PHONGO_TYPEMAP_CLASS:
+			if (!php_phongo_bson_unserialize_object(state->odm_ce ? state->odm_ce : state->map.root.ce, &state->zchild)) {
+				/* Exception already thrown */
+				goto cleanup;
+			}
 			break;
-		}
 
 		case PHONGO_TYPEMAP_NATIVE_OBJECT:
 		default:
@@ -1210,8 +1357,10 @@ cleanup:
 }
 
 /* Fetches a zend_class_entry for the given class name and checks that it is
- * also instantiatable and implements a specified interface. Returns the class
- * on success; otherwise, NULL is returned and an exception is thrown. */
+ * also instantiatable and implements a specified interface or, as an
+ * alternative to MongoDB\BSON\Unserializable, MongoDB\BSON\Hydratable.
+ * Returns the class on success; otherwise, NULL is returned and an exception is
+ * thrown. */
 static zend_class_entry* php_phongo_bson_state_fetch_class(const char* classname, int classname_len, zend_class_entry* interface_ce)
 {
 	zend_string*      zs_classname = zend_string_init(classname, classname_len, 0);
@@ -1222,7 +1371,7 @@ static zend_class_entry* php_phongo_bson_state_fetch_class(const char* classname
 		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Class %s does not exist", classname);
 	} else if (!phongo_is_class_instantiatable(found_ce)) {
 		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "%s %s is not instantiatable", zend_get_object_type_uc(found_ce), classname);
-	} else if (!instanceof_function(found_ce, interface_ce)) {
+	} else if (!instanceof_function(found_ce, interface_ce) && !(interface_ce == php_phongo_unserializable_ce && instanceof_function(found_ce, php_phongo_hydratable_ce))) {
 		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Class %s does not implement %s", classname, ZSTR_VAL(interface_ce->name));
 	} else {
 		return found_ce;
@@ -1231,6 +1380,29 @@ static zend_class_entry* php_phongo_bson_state_fetch_class(const char* classname
 	return NULL;
 }
 
+/* Parses the name of a scalar coercion. Returns PHONGO_TYPEMAP_NONE if the name
+ * is not recognized. */
+static php_phongo_bson_typemap_types php_phongo_bson_parse_scalar_type(const char* type)
+{
+	if (!strcasecmp(type, PHONGO_TYPEMAP_TYPE_STR_STRING)) {
+		return PHONGO_TYPEMAP_NATIVE_STRING;
+	}
+
+	if (!strcasecmp(type, PHONGO_TYPEMAP_TYPE_STR_BINARY)) {
+		return PHONGO_TYPEMAP_NATIVE_BINARY;
+	}
+
+	if (!strcasecmp(type, PHONGO_TYPEMAP_TYPE_STR_INT)) {
+		return PHONGO_TYPEMAP_NATIVE_INT;
+	}
+
+	if (!strcasecmp(type, PHONGO_TYPEMAP_TYPE_STR_DATETIMEIMMUTABLE)) {
+		return PHONGO_TYPEMAP_DATETIMEIMMUTABLE;
+	}
+
+	return PHONGO_TYPEMAP_NONE;
+}
+
 /* Parses a BSON type (i.e. array, document, or root). On success, the type and
  * type_ce output arguments will be assigned and true will be returned;
  * otherwise, false is returned and an exception is thrown. */
@@ -1279,16 +1451,16 @@ static void field_path_map_element_set_info(php_phongo_field_path_map_element* e
 	element->node.ce   = typemap_element->ce;
 }
 
-static void map_add_field_path_element(php_phongo_bson_typemap* map, php_phongo_field_path_map_element* element)
+static void map_add_field_path_element(php_phongo_bson_typemap_field_paths* field_paths, php_phongo_field_path_map_element* element)
 {
 	/* Make sure we have allocated enough */
-	if (map->field_paths.allocated_size < map->field_paths.size + 1) {
-		map->field_paths.allocated_size += PHONGO_FIELD_PATH_EXPANSION;
-		map->field_paths.map = erealloc(map->field_paths.map, sizeof(php_phongo_field_path_map_element) * map->field_paths.allocated_size);
+	if (field_paths->allocated_size < field_paths->size + 1) {
+		field_paths->allocated_size += PHONGO_FIELD_PATH_EXPANSION;
+		field_paths->map = erealloc(field_paths->map, sizeof(php_phongo_field_path_map_element) * field_paths->allocated_size);
 	}
 
-	map->field_paths.map[map->field_paths.size] = element;
-	map->field_paths.size++;
+	field_paths->map[field_paths->size] = element;
+	field_paths->size++;
 }
 
 static php_phongo_field_path_map_element* field_path_map_element_alloc(void)
@@ -1306,6 +1478,34 @@ static void field_path_map_element_dtor(php_phongo_field_path_map_element* eleme
 	efree(element);
 }
 
+/* Returns whether the field paths already contain the path of the given element
+ * with a type of the other kind, i.e. a scalar coercion for a path with a
+ * document or array type, or vice versa. */
+static bool field_path_map_has_conflict(php_phongo_bson_typemap_field_paths* field_paths, php_phongo_field_path_map_element* element)
+{
+	size_t i, j;
+
+	for (i = 0; i < field_paths->size; i++) {
+		php_phongo_field_path_map_element* existing = field_paths->map[i];
+
+		if (existing->entry->size != element->entry->size || PHONGO_TYPEMAP_IS_SCALAR(existing->node.type) == PHONGO_TYPEMAP_IS_SCALAR(element->node.type)) {
+			continue;
+		}
+
+		for (j = 0; j < element->entry->size; j++) {
+			if (strcmp(existing->entry->elements[j], element->entry->elements[j]) != 0) {
+				break;
+			}
+		}
+
+		if (j == element->entry->size) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static bool php_phongo_bson_state_add_field_path(php_phongo_bson_typemap* map, char* field_path_original, php_phongo_bson_typemap_element* typemap_element)
 {
 	char*                              ptr         = NULL;
@@ -1348,23 +1548,186 @@ static bool php_phongo_bson_state_add_field_path(php_phongo_bson_typemap* map, c
 	php_phongo_field_path_push(field_path_map_element->entry, ptr, PHONGO_FIELD_PATH_ITEM_NONE);
 
 	field_path_map_element_set_info(field_path_map_element, typemap_element);
-	map_add_field_path_element(map, field_path_map_element);
+
+	if (field_path_map_has_conflict(map->field_paths, field_path_map_element)) {
+		field_path_map_element_dtor(field_path_map_element);
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The field path '%s' may not be specified in both the 'fieldPaths' and 'types' elements", field_path_original);
+		return false;
+	}
+
+	map_add_field_path_element(map->field_paths, field_path_map_element);
 
 	return true;
 }
 
-void php_phongo_bson_typemap_dtor(php_phongo_bson_typemap* map)
+static void field_path_node_free(php_phongo_field_path_node* node)
+{
+	if (node->children) {
+		zend_hash_destroy(node->children);
+		FREE_HASHTABLE(node->children);
+	}
+
+	if (node->wildcard) {
+		field_path_node_free(node->wildcard);
+	}
+
+	efree(node);
+}
+
+static void field_path_node_hash_dtor(zval* zv)
+{
+	field_path_node_free((php_phongo_field_path_node*) Z_PTR_P(zv));
+}
+
+/* Builds the trie node for all field path entries (in type map order) that are
+ * still candidates at the given depth. The first entry ending at this depth
+ * determines the node's type, which preserves the precedence of the original
+ * type map. Scalar coercions are tracked separately, so they never replace the
+ * type of an embedded document or array. Entries with a wildcard segment are included beneath every explicit
+ * key at that level as well as beneath the wildcard node. */
+static php_phongo_field_path_node* field_path_node_build(php_phongo_field_path_map_element** entries, size_t count, size_t depth)
+{
+	php_phongo_field_path_node*         node;
+	php_phongo_field_path_map_element** subset;
+	HashTable                           keys;
+	size_t                              subset_count;
+	size_t                              i;
+
+	if (count == 0) {
+		return NULL;
+	}
+
+	node = ecalloc(1, sizeof(php_phongo_field_path_node));
+
+	for (i = 0; i < count; i++) {
+		if (entries[i]->entry->size != depth) {
+			continue;
+		}
+
+		if (PHONGO_TYPEMAP_IS_SCALAR(entries[i]->node.type)) {
+			if (node->scalar_type == PHONGO_TYPEMAP_NONE) {
+				node->scalar_type = entries[i]->node.type;
+			}
+		} else if (!node->has_type) {
+			node->has_type  = true;
+			node->type.type = entries[i]->node.type;
+			node->type.ce   = entries[i]->node.ce;
+		}
+	}
+
+	subset = emalloc(sizeof(php_phongo_field_path_map_element*) * count);
+
+	/* Collect the distinct explicit keys at this depth */
+	zend_hash_init(&keys, 8, NULL, NULL, 0);
+
+	for (i = 0; i < count; i++) {
+		const char* segment;
+
+		if (entries[i]->entry->size <= depth) {
+			continue;
+		}
+
+		segment = entries[i]->entry->elements[depth];
+
+		if (strcmp(segment, "$") != 0) {
+			zend_hash_str_add_empty_element(&keys, segment, strlen(segment));
+		}
+	}
+
+	if (zend_hash_num_elements(&keys) > 0) {
+		zend_string* key;
+
+		ALLOC_HASHTABLE(node->children);
+		zend_hash_init(node->children, zend_hash_num_elements(&keys), NULL, field_path_node_hash_dtor, 0);
+
+		ZEND_HASH_FOREACH_STR_KEY(&keys, key)
+		{
+			subset_count = 0;
+
+			for (i = 0; i < count; i++) {
+				const char* segment;
+
+				if (entries[i]->entry->size <= depth) {
+					continue;
+				}
+
+				segment = entries[i]->entry->elements[depth];
+
+				if (strcmp(segment, "$") == 0 || strcmp(ZSTR_VAL(key), segment) == 0) {
+					subset[subset_count++] = entries[i];
+				}
+			}
+
+			zend_hash_add_new_ptr(node->children, key, field_path_node_build(subset, subset_count, depth + 1));
+		}
+		ZEND_HASH_FOREACH_END();
+	}
+
+	zend_hash_destroy(&keys);
+
+	subset_count = 0;
+
+	for (i = 0; i < count; i++) {
+		if (entries[i]->entry->size > depth && strcmp(entries[i]->entry->elements[depth], "$") == 0) {
+			subset[subset_count++] = entries[i];
+		}
+	}
+
+	node->wildcard = field_path_node_build(subset, subset_count, depth + 1);
+
+	efree(subset);
+
+	return node;
+}
+
+static void field_paths_free(php_phongo_bson_typemap_field_paths* field_paths)
 {
 	size_t i;
 
-	if (map->field_paths.map) {
-		for (i = 0; i < map->field_paths.size; i++) {
-			field_path_map_element_dtor(map->field_paths.map[i]);
+	if (field_paths->map) {
+		for (i = 0; i < field_paths->size; i++) {
+			field_path_map_element_dtor(field_paths->map[i]);
+		}
+		efree(field_paths->map);
+	}
+
+	if (field_paths->trie) {
+		field_path_node_free(field_paths->trie);
+	}
+
+	efree(field_paths);
+}
+
+void php_phongo_bson_typemap_dtor(php_phongo_bson_typemap* map)
+{
+	if (map->field_paths) {
+		map->field_paths->ref_count--;
+
+		if (map->field_paths->ref_count < 1) {
+			field_paths_free(map->field_paths);
 		}
-		efree(map->field_paths.map);
 	}
 
-	map->field_paths.map = NULL;
+	map->field_paths = NULL;
+}
+
+/* Element destructor for the per-request type map cache */
+void php_phongo_bson_typemap_cache_dtor(zval* zv)
+{
+	php_phongo_bson_typemap* map = (php_phongo_bson_typemap*) Z_PTR_P(zv);
+
+	php_phongo_bson_typemap_dtor(map);
+	efree(map);
+}
+
+static void php_phongo_bson_typemap_init_field_paths(php_phongo_bson_typemap* map)
+{
+	if (map->field_paths) {
+		return;
+	}
+
+	map->field_paths            = ecalloc(1, sizeof(php_phongo_bson_typemap_field_paths));
+	map->field_paths->ref_count = 1;
 }
 
 /* Loops over each element in the fieldPaths array (if exists, and is an
@@ -1387,6 +1750,8 @@ static bool php_phongo_bson_state_parse_fieldpaths(zval* typemap, php_phongo_bso
 
 	ht_data = HASH_OF(fieldpaths);
 
+	php_phongo_bson_typemap_init_field_paths(map);
+
 	{
 		zend_string* string_key = NULL;
 		zend_ulong   num_key    = 0;
@@ -1420,23 +1785,183 @@ static bool php_phongo_bson_state_parse_fieldpaths(zval* typemap, php_phongo_bso
 	return true;
 }
 
+/* Parses the "fieldPaths" element of the "types" map, which specifies scalar
+ * coercions for individual fields. These are kept apart from the "fieldPaths"
+ * element of the type map, whose values are class names. */
+static bool php_phongo_bson_state_parse_types_fieldpaths(zval* fieldpaths, php_phongo_bson_typemap* map)
+{
+	zend_string* string_key;
+	zval*        value;
+
+	if (Z_TYPE_P(fieldpaths) != IS_ARRAY) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types.fieldPaths' element is not an array");
+		return false;
+	}
+
+	php_phongo_bson_typemap_init_field_paths(map);
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(fieldpaths), string_key, value)
+	{
+		php_phongo_bson_typemap_element element = { PHONGO_TYPEMAP_NONE, NULL };
+
+		if (!string_key) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types.fieldPaths' element is not an associative array");
+			return false;
+		}
+
+		if (ZSTR_LEN(string_key) == 0) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types.fieldPaths' element may not be an empty string");
+			return false;
+		}
+
+		ZVAL_DEREF(value);
+
+		if (Z_TYPE_P(value) != IS_STRING || (element.type = php_phongo_bson_parse_scalar_type(Z_STRVAL_P(value))) == PHONGO_TYPEMAP_NONE) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected 'types.fieldPaths' element '%s' to be 'string', 'binary', 'int', or 'DateTimeImmutable'", ZSTR_VAL(string_key));
+			return false;
+		}
+
+		if (!php_phongo_bson_state_add_field_path(map, ZSTR_VAL(string_key), &element)) {
+			return false;
+		}
+	}
+	ZEND_HASH_FOREACH_END();
+
+	return true;
+}
+
+/* Parses the "types" element of the type map, which specifies scalar coercions
+ * for BSON types that are otherwise decoded as objects. The value "object"
+ * selects the default BSON class instance, which is only meaningful for int64
+ * since 64-bit integers are otherwise decoded as native integers where
+ * possible. Coercions for individual fields are specified by its "fieldPaths"
+ * element and take precedence over these defaults. */
+static bool php_phongo_bson_state_parse_types(zval* typemap, php_phongo_bson_typemap* map)
+{
+	zval*        types;
+	zend_string* string_key;
+	zval*        value;
+
+	if (!php_array_existsc(typemap, PHONGO_TYPEMAP_FIELD_STR_TYPES)) {
+		return true;
+	}
+
+	types = php_array_fetchc_array(typemap, PHONGO_TYPEMAP_FIELD_STR_TYPES);
+
+	if (!types) {
+		phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types' element is not an array");
+		return false;
+	}
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(HASH_OF(types), string_key, value)
+	{
+		php_phongo_bson_typemap_types type;
+
+		if (!string_key) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types' element is not an associative array");
+			return false;
+		}
+
+		ZVAL_DEREF(value);
+
+		if (zend_string_equals_literal(string_key, "fieldPaths")) {
+			if (!php_phongo_bson_state_parse_types_fieldpaths(value, map)) {
+				/* Exception already thrown */
+				return false;
+			}
+
+			continue;
+		}
+
+		if (Z_TYPE_P(value) != IS_STRING) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "Expected 'types' element '%s' to be a string, %s given", ZSTR_VAL(string_key), zend_zval_type_name(value));
+			return false;
+		}
+
+		if (!strcasecmp(Z_STRVAL_P(value), PHONGO_TYPEMAP_TYPE_STR_OBJECT)) {
+			type = PHONGO_TYPEMAP_BSON;
+		} else {
+			type = php_phongo_bson_parse_scalar_type(Z_STRVAL_P(value));
+		}
+
+		if (zend_string_equals_literal(string_key, "objectId") && (type == PHONGO_TYPEMAP_NATIVE_STRING || type == PHONGO_TYPEMAP_NATIVE_BINARY || type == PHONGO_TYPEMAP_BSON)) {
+			map->types.objectid = type;
+		} else if (zend_string_equals_literal(string_key, "utcDateTime") && (type == PHONGO_TYPEMAP_NATIVE_INT || type == PHONGO_TYPEMAP_DATETIMEIMMUTABLE || type == PHONGO_TYPEMAP_BSON)) {
+			map->types.utcdatetime = type;
+		} else if (zend_string_equals_literal(string_key, "decimal128") && (type == PHONGO_TYPEMAP_NATIVE_STRING || type == PHONGO_TYPEMAP_BSON)) {
+			map->types.decimal128 = type;
+		} else if (zend_string_equals_literal(string_key, "int64") && (type == PHONGO_TYPEMAP_NATIVE_INT || type == PHONGO_TYPEMAP_BSON)) {
+			map->types.int64 = type;
+		} else if (zend_string_equals_literal(string_key, "objectId") || zend_string_equals_literal(string_key, "utcDateTime") || zend_string_equals_literal(string_key, "decimal128") || zend_string_equals_literal(string_key, "int64")) {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "BSON type '%s' cannot be decoded as '%s'", ZSTR_VAL(string_key), Z_STRVAL_P(value));
+			return false;
+		} else {
+			phongo_throw_exception(PHONGO_ERROR_INVALID_ARGUMENT, "The 'types' element does not support BSON type '%s'", ZSTR_VAL(string_key));
+			return false;
+		}
+	}
+	ZEND_HASH_FOREACH_END();
+
+	return true;
+}
+
 /* Applies the array argument to a typemap struct. Returns true on success;
- * otherwise, false is returned an an exception is thrown. */
+ * otherwise, false is returned an an exception is thrown.
+ *
+ * Type maps given as immutable arrays (e.g. array literals cached by OPcache)
+ * cannot change for the remainder of the request, so the parsed result is
+ * cached by the array's address. Subsequent calls with the same array copy the
+ * cached type map and share its reference-counted fieldPaths, which skips class
+ * lookups and field path allocations entirely. The cache is cleared in
+ * RSHUTDOWN, since class entries may not outlive the request. */
 bool php_phongo_bson_typemap_to_state(zval* typemap, php_phongo_bson_typemap* map)
 {
+	php_phongo_bson_typemap* cached;
+	bool                     cacheable;
+
 	if (!typemap) {
 		return true;
 	}
 
+	cacheable = MONGODB_G(typemaps) && (GC_FLAGS(Z_ARRVAL_P(typemap)) & IS_ARRAY_IMMUTABLE);
+
+	if (cacheable && (cached = zend_hash_index_find_ptr(MONGODB_G(typemaps), (zend_ulong) (uintptr_t) Z_ARRVAL_P(typemap)))) {
+		*map = *cached;
+
+		if (map->field_paths) {
+			map->field_paths->ref_count++;
+		}
+
+		return true;
+	}
+
 	if (!php_phongo_bson_state_parse_type(typemap, PHONGO_TYPEMAP_FIELD_STR_ARRAY, &map->array) ||
 		!php_phongo_bson_state_parse_type(typemap, PHONGO_TYPEMAP_FIELD_STR_DOCUMENT, &map->document) ||
 		!php_phongo_bson_state_parse_type(typemap, PHONGO_TYPEMAP_FIELD_STR_ROOT, &map->root) ||
-		!php_phongo_bson_state_parse_fieldpaths(typemap, map)) {
+		!php_phongo_bson_state_parse_fieldpaths(typemap, map) ||
+		!php_phongo_bson_state_parse_types(typemap, map)) {
 
-		/* Exception should already have been thrown */
+		/* Exception should already have been thrown. Free any fieldPaths that
+		 * were parsed before the error was encountered. */
+		php_phongo_bson_typemap_dtor(map);
 		return false;
 	}
 
+	if (map->field_paths) {
+		map->field_paths->trie = field_path_node_build(map->field_paths->map, map->field_paths->size, 0);
+	}
+
+	if (cacheable) {
+		cached  = emalloc(sizeof(php_phongo_bson_typemap));
+		*cached = *map;
+
+		if (cached->field_paths) {
+			cached->field_paths->ref_count++;
+		}
+
+		zend_hash_index_update_ptr(MONGODB_G(typemaps), (zend_ulong) (uintptr_t) Z_ARRVAL_P(typemap), cached);
+	}
+
 	return true;
 }
 
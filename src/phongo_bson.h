@@ -45,9 +45,17 @@ typedef enum {
 	PHONGO_TYPEMAP_NATIVE_ARRAY,
 	PHONGO_TYPEMAP_NATIVE_OBJECT,
 	PHONGO_TYPEMAP_CLASS,
-	PHONGO_TYPEMAP_BSON
+	PHONGO_TYPEMAP_BSON,
+	PHONGO_TYPEMAP_NATIVE_STRING,
+	PHONGO_TYPEMAP_NATIVE_BINARY,
+	PHONGO_TYPEMAP_NATIVE_INT,
+	PHONGO_TYPEMAP_DATETIMEIMMUTABLE
 } php_phongo_bson_typemap_types;
 
+/* Scalar coercions apply to BSON types that are otherwise decoded as objects
+ * (e.g. ObjectId). They may only be used in the types map. */
+#define PHONGO_TYPEMAP_IS_SCALAR(t) ((t) >= PHONGO_TYPEMAP_NATIVE_STRING)
+
 typedef struct {
 	php_phongo_bson_typemap_types type;
 	zend_class_entry*             ce;
@@ -58,16 +66,49 @@ typedef struct {
 	php_phongo_bson_typemap_element node;
 } php_phongo_field_path_map_element;
 
+/* Compiled form of the fieldPaths type map. Each node corresponds to a nesting
+ * level and maps a field name to the next node. The wildcard node is followed
+ * for any field name without an explicit entry. Nodes reached through an
+ * explicit field name also include all wildcard paths, so a lookup never needs
+ * to backtrack. The type applies to embedded documents and arrays, while the
+ * scalar type holds the coercion from the "fieldPaths" element of the "types"
+ * map (PHONGO_TYPEMAP_NONE if there is none). */
+typedef struct _php_phongo_field_path_node php_phongo_field_path_node;
+
+struct _php_phongo_field_path_node {
+	HashTable*                      children;
+	php_phongo_field_path_node*     wildcard;
+	bool                            has_type;
+	php_phongo_bson_typemap_element type;
+	php_phongo_bson_typemap_types   scalar_type;
+};
+
+/* Parsed fieldPaths entries are reference counted, since type maps may be
+ * shared between decoding states and the per-request type map cache. */
+typedef struct {
+	php_phongo_field_path_map_element** map;
+	size_t                              allocated_size;
+	size_t                              size;
+	php_phongo_field_path_node*         trie;
+	size_t                              ref_count;
+} php_phongo_bson_typemap_field_paths;
+
+/* Default coercions for scalar BSON types, as specified by the "types" key of
+ * the type map. PHONGO_TYPEMAP_NONE decodes the value as usual. */
+typedef struct {
+	php_phongo_bson_typemap_types objectid;
+	php_phongo_bson_typemap_types utcdatetime;
+	php_phongo_bson_typemap_types decimal128;
+	php_phongo_bson_typemap_types int64;
+} php_phongo_bson_typemap_scalar_types;
+
 typedef struct {
-	php_phongo_bson_typemap_element document;
-	php_phongo_bson_typemap_element array;
-	php_phongo_bson_typemap_element root;
-	bool                            int64_as_object;
-	struct {
-		php_phongo_field_path_map_element** map;
-		size_t                              allocated_size;
-		size_t                              size;
-	} field_paths;
+	php_phongo_bson_typemap_element      document;
+	php_phongo_bson_typemap_element      array;
+	php_phongo_bson_typemap_element      root;
+	php_phongo_bson_typemap_scalar_types types;
+	bool                                 int64_as_object;
+	php_phongo_bson_typemap_field_paths* field_paths;
 } php_phongo_bson_typemap;
 
 typedef struct {
@@ -76,6 +117,7 @@ typedef struct {
 	zend_class_entry*               odm_ce;
 	bool                            is_visiting_array;
 	php_phongo_field_path*          field_path;
+	php_phongo_field_path_node*     field_path_node;
 	php_phongo_bson_typemap_element field_type;
 } php_phongo_bson_state;
 
@@ -116,5 +158,6 @@ bool phongo_bson_value_to_zval_legacy(const bson_value_t* value, zval* zv);
 
 bool php_phongo_bson_typemap_to_state(zval* typemap, php_phongo_bson_typemap* map);
 void php_phongo_bson_typemap_dtor(php_phongo_bson_typemap* map);
+void php_phongo_bson_typemap_cache_dtor(zval* zv);
 
 #endif /* PHONGO_BSON_H */
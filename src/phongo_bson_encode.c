@@ -19,12 +19,16 @@
 #include <php.h>
 #include <Zend/zend_enum.h>
 #include <Zend/zend_interfaces.h>
+#if PHP_VERSION_ID >= 80400
+#include <Zend/zend_lazy_objects.h>
+#endif
 
 #include "php_phongo.h"
 #include "phongo_bson.h"
 #include "phongo_bson_encode.h"
 #include "phongo_compat.h"
 #include "phongo_error.h"
+#include "phongo_util.h"
 
 #undef MONGOC_LOG_DOMAIN
 #define MONGOC_LOG_DOMAIN "PHONGO-BSON"
@@ -43,9 +47,56 @@
 #error Unsupported architecture (integers are neither 32-bit nor 64-bit)
 #endif
 
+/* An element being encoded, linked to the element of the document or array
+ * that contains it. Frames live on the C stack of the encoding functions, so
+ * the field path is only assembled if an error needs to be reported. A NULL
+ * frame denotes the root document. */
+typedef struct _php_phongo_bson_encode_frame php_phongo_bson_encode_frame;
+
+struct _php_phongo_bson_encode_frame {
+	const php_phongo_bson_encode_frame* parent;
+	const char*                         key;
+};
+
 /* Forwards declarations */
-static void php_phongo_bson_append(bson_t* bson, php_phongo_field_path* field_path, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* entry);
-static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path* field_path, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out);
+static void php_phongo_bson_append(bson_t* bson, const php_phongo_bson_encode_frame* parent, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* entry);
+static void php_phongo_zval_to_bson_internal(zval* data, const php_phongo_bson_encode_frame* parent, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out);
+
+/* Returns the dotted field path of the given frame. The caller is responsible
+ * for freeing the returned string. */
+static char* php_phongo_bson_encode_frame_path(const php_phongo_bson_encode_frame* frame)
+{
+	const php_phongo_bson_encode_frame* tmp;
+	size_t                              length = 0;
+	char*                               path;
+	char*                               ptr;
+
+	if (!frame) {
+		return estrdup("");
+	}
+
+	for (tmp = frame; tmp; tmp = tmp->parent) {
+		length += strlen(tmp->key) + 1;
+	}
+
+	/* The separator counted for the root element is used by the terminator */
+	path = emalloc(length);
+	ptr  = path + length - 1;
+	*ptr = '\0';
+
+	for (tmp = frame; tmp; tmp = tmp->parent) {
+		size_t key_len = strlen(tmp->key);
+
+		ptr -= key_len;
+		memcpy(ptr, tmp->key, key_len);
+
+		if (tmp->parent) {
+			*--ptr = '.';
+		}
+	}
+
+	return path;
+}
 
 /* Determines whether the argument should be serialized as a BSON array or
  * document. IS_ARRAY is returned if the argument's keys are a sequence of
@@ -135,6 +186,124 @@ static inline bool phongo_check_bson_serialize_return_type(zval* retval, zend_cl
 	return false;
 }
 
+/* Encoding strategies for objects. The strategy only depends on the class of
+ * an object, so it is determined once per class and cached for the request in
+ * MONGODB_G(bson_classes) instead of checking each class or interface in turn
+ * for every object value. */
+typedef enum {
+	PHONGO_BSON_ENCODE_PROPERTIES = 0,
+	PHONGO_BSON_ENCODE_CURSORID,
+	PHONGO_BSON_ENCODE_DOCUMENT,
+	PHONGO_BSON_ENCODE_PACKEDARRAY,
+	PHONGO_BSON_ENCODE_SERIALIZABLE,
+	PHONGO_BSON_ENCODE_PERSISTABLE,
+	PHONGO_BSON_ENCODE_OBJECTID,
+	PHONGO_BSON_ENCODE_UTCDATETIME,
+	PHONGO_BSON_ENCODE_BINARY,
+	PHONGO_BSON_ENCODE_DECIMAL128,
+	PHONGO_BSON_ENCODE_INT64,
+	PHONGO_BSON_ENCODE_REGEX,
+	PHONGO_BSON_ENCODE_JAVASCRIPT,
+	PHONGO_BSON_ENCODE_TIMESTAMP,
+	PHONGO_BSON_ENCODE_MAXKEY,
+	PHONGO_BSON_ENCODE_MINKEY,
+	PHONGO_BSON_ENCODE_DBPOINTER,
+	PHONGO_BSON_ENCODE_SYMBOL,
+	PHONGO_BSON_ENCODE_UNDEFINED,
+	PHONGO_BSON_ENCODE_UNEXPECTED_TYPE,
+	PHONGO_BSON_ENCODE_ENUM,
+} php_phongo_bson_encode_strategy;
+
+static php_phongo_bson_encode_strategy php_phongo_bson_encode_strategy_for_class(zend_class_entry* ce)
+{
+	if (instanceof_function(ce, php_phongo_cursorid_ce)) {
+		return PHONGO_BSON_ENCODE_CURSORID;
+	}
+
+	if (instanceof_function(ce, php_phongo_type_ce)) {
+		if (instanceof_function(ce, php_phongo_document_ce)) {
+			return PHONGO_BSON_ENCODE_DOCUMENT;
+		}
+		if (instanceof_function(ce, php_phongo_packedarray_ce)) {
+			return PHONGO_BSON_ENCODE_PACKEDARRAY;
+		}
+		if (instanceof_function(ce, php_phongo_serializable_ce)) {
+			return instanceof_function(ce, php_phongo_persistable_ce) ? PHONGO_BSON_ENCODE_PERSISTABLE : PHONGO_BSON_ENCODE_SERIALIZABLE;
+		}
+		if (instanceof_function(ce, php_phongo_objectid_ce)) {
+			return PHONGO_BSON_ENCODE_OBJECTID;
+		}
+		if (instanceof_function(ce, php_phongo_utcdatetime_ce)) {
+			return PHONGO_BSON_ENCODE_UTCDATETIME;
+		}
+		if (instanceof_function(ce, php_phongo_binary_ce)) {
+			return PHONGO_BSON_ENCODE_BINARY;
+		}
+		if (instanceof_function(ce, php_phongo_decimal128_ce)) {
+			return PHONGO_BSON_ENCODE_DECIMAL128;
+		}
+		if (instanceof_function(ce, php_phongo_int64_ce)) {
+			return PHONGO_BSON_ENCODE_INT64;
+		}
+		if (instanceof_function(ce, php_phongo_regex_ce)) {
+			return PHONGO_BSON_ENCODE_REGEX;
+		}
+		if (instanceof_function(ce, php_phongo_javascript_ce)) {
+			return PHONGO_BSON_ENCODE_JAVASCRIPT;
+		}
+		if (instanceof_function(ce, php_phongo_timestamp_ce)) {
+			return PHONGO_BSON_ENCODE_TIMESTAMP;
+		}
+		if (instanceof_function(ce, php_phongo_maxkey_ce)) {
+			return PHONGO_BSON_ENCODE_MAXKEY;
+		}
+		if (instanceof_function(ce, php_phongo_minkey_ce)) {
+			return PHONGO_BSON_ENCODE_MINKEY;
+		}
+
+		/* Deprecated types */
+		if (instanceof_function(ce, php_phongo_dbpointer_ce)) {
+			return PHONGO_BSON_ENCODE_DBPOINTER;
+		}
+		if (instanceof_function(ce, php_phongo_symbol_ce)) {
+			return PHONGO_BSON_ENCODE_SYMBOL;
+		}
+		if (instanceof_function(ce, php_phongo_undefined_ce)) {
+			return PHONGO_BSON_ENCODE_UNDEFINED;
+		}
+
+		return PHONGO_BSON_ENCODE_UNEXPECTED_TYPE;
+	}
+
+	if (ce->ce_flags & ZEND_ACC_ENUM) {
+		return PHONGO_BSON_ENCODE_ENUM;
+	}
+
+	return PHONGO_BSON_ENCODE_PROPERTIES;
+}
+
+static php_phongo_bson_encode_strategy php_phongo_bson_get_encode_strategy(zend_class_entry* ce)
+{
+	HashTable*                      cache = MONGODB_G(bson_classes);
+	zend_ulong                      key   = (zend_ulong) (uintptr_t) ce;
+	zval*                           cached;
+	zval                            zstrategy;
+	php_phongo_bson_encode_strategy strategy;
+
+	if (cache && (cached = zend_hash_index_find(cache, key))) {
+		return (php_phongo_bson_encode_strategy) Z_LVAL_P(cached);
+	}
+
+	strategy = php_phongo_bson_encode_strategy_for_class(ce);
+
+	if (cache) {
+		ZVAL_LONG(&zstrategy, strategy);
+		zend_hash_index_add_new(cache, key, &zstrategy);
+	}
+
+	return strategy;
+}
+
 /* Appends the array or object argument to the BSON document.
  *
  * For instances of MongoDB\BSON\Document, raw BSON data is appended as document.
@@ -145,29 +314,29 @@ static inline bool phongo_check_bson_serialize_return_type(zval* retval, zend_cl
  * type.
  * Other array or object values will be appended as an embedded document.
  */
-static void php_phongo_bson_append_object(bson_t* bson, php_phongo_field_path* field_path, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* object)
+static void php_phongo_bson_append_object(bson_t* bson, const php_phongo_bson_encode_frame* frame, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* object)
 {
-	if (Z_TYPE_P(object) == IS_OBJECT && instanceof_function(Z_OBJCE_P(object), php_phongo_cursorid_ce)) {
-		bson_append_int64(bson, key, key_len, Z_CURSORID_OBJ_P(object)->id);
-		return;
-	}
+	php_phongo_bson_encode_strategy strategy = PHONGO_BSON_ENCODE_PROPERTIES;
 
-	if (Z_TYPE_P(object) == IS_OBJECT && instanceof_function(Z_OBJCE_P(object), php_phongo_type_ce)) {
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_document_ce)) {
-			php_phongo_document_t* intern = Z_DOCUMENT_OBJ_P(object);
-			bson_append_document(bson, key, key_len, intern->bson);
+	if (Z_TYPE_P(object) == IS_OBJECT) {
+		strategy = php_phongo_bson_get_encode_strategy(Z_OBJCE_P(object));
+	}
 
+	switch (strategy) {
+		case PHONGO_BSON_ENCODE_CURSORID:
+			bson_append_int64(bson, key, key_len, Z_CURSORID_OBJ_P(object)->id);
 			return;
-		}
 
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_packedarray_ce)) {
-			php_phongo_packedarray_t* intern = Z_PACKEDARRAY_OBJ_P(object);
-			bson_append_array(bson, key, key_len, intern->bson);
+		case PHONGO_BSON_ENCODE_DOCUMENT:
+			bson_append_document(bson, key, key_len, Z_DOCUMENT_OBJ_P(object)->bson);
+			return;
 
+		case PHONGO_BSON_ENCODE_PACKEDARRAY:
+			bson_append_array(bson, key, key_len, Z_PACKEDARRAY_OBJ_P(object)->bson);
 			return;
-		}
 
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_serializable_ce)) {
+		case PHONGO_BSON_ENCODE_SERIALIZABLE:
+		case PHONGO_BSON_ENCODE_PERSISTABLE: {
 			zval   obj_data;
 			bson_t child;
 
@@ -185,18 +354,35 @@ static void php_phongo_bson_append_object(bson_t* bson, php_phongo_field_path* f
 				return;
 			}
 
+			/* A Document or PackedArray returned by bsonSerialize() already
+			 * holds the encoded value, which can be appended as-is unless the
+			 * class name of a Persistable object must be injected. */
+			if (strategy == PHONGO_BSON_ENCODE_SERIALIZABLE && Z_TYPE(obj_data) == IS_OBJECT) {
+				if (instanceof_function(Z_OBJCE(obj_data), php_phongo_document_ce)) {
+					bson_append_document(bson, key, key_len, Z_DOCUMENT_OBJ_P(&obj_data)->bson);
+					zval_ptr_dtor(&obj_data);
+					return;
+				}
+
+				if (instanceof_function(Z_OBJCE(obj_data), php_phongo_packedarray_ce)) {
+					bson_append_array(bson, key, key_len, Z_PACKEDARRAY_OBJ_P(&obj_data)->bson);
+					zval_ptr_dtor(&obj_data);
+					return;
+				}
+			}
+
 			/* Persistable objects must always be serialized as BSON documents;
 			 * otherwise, infer based on bsonSerialize()'s return value. */
-			if (instanceof_function(Z_OBJCE_P(object), php_phongo_persistable_ce) || php_phongo_is_array_or_document(&obj_data) != IS_ARRAY) {
+			if (strategy == PHONGO_BSON_ENCODE_PERSISTABLE || php_phongo_is_array_or_document(&obj_data) != IS_ARRAY) {
 				bson_append_document_begin(bson, key, key_len, &child);
-				if (instanceof_function(Z_OBJCE_P(object), php_phongo_persistable_ce)) {
+				if (strategy == PHONGO_BSON_ENCODE_PERSISTABLE) {
 					bson_append_binary(&child, PHONGO_ODM_FIELD_NAME, -1, 0x80, (const uint8_t*) Z_OBJCE_P(object)->name->val, Z_OBJCE_P(object)->name->len);
 				}
-				php_phongo_zval_to_bson_internal(&obj_data, field_path, flags, &child, NULL);
+				php_phongo_zval_to_bson_internal(&obj_data, frame, flags, &child, NULL);
 				bson_append_document_end(bson, &child);
 			} else {
 				bson_append_array_begin(bson, key, key_len, &child);
-				php_phongo_zval_to_bson_internal(&obj_data, field_path, flags, &child, NULL);
+				php_phongo_zval_to_bson_internal(&obj_data, frame, flags, &child, NULL);
 				bson_append_array_end(bson, &child);
 			}
 
@@ -204,45 +390,37 @@ static void php_phongo_bson_append_object(bson_t* bson, php_phongo_field_path* f
 			return;
 		}
 
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_objectid_ce)) {
-			bson_oid_t             oid;
-			php_phongo_objectid_t* intern = Z_OBJECTID_OBJ_P(object);
-
-			bson_oid_init_from_string(&oid, intern->oid);
-			bson_append_oid(bson, key, key_len, &oid);
+		case PHONGO_BSON_ENCODE_OBJECTID:
+			bson_append_oid(bson, key, key_len, &Z_OBJECTID_OBJ_P(object)->oid);
 			return;
-		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_utcdatetime_ce)) {
-			php_phongo_utcdatetime_t* intern = Z_UTCDATETIME_OBJ_P(object);
 
-			bson_append_date_time(bson, key, key_len, intern->milliseconds);
+		case PHONGO_BSON_ENCODE_UTCDATETIME:
+			bson_append_date_time(bson, key, key_len, Z_UTCDATETIME_OBJ_P(object)->milliseconds);
 			return;
-		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_binary_ce)) {
+
+		case PHONGO_BSON_ENCODE_BINARY: {
 			php_phongo_binary_t* intern = Z_BINARY_OBJ_P(object);
 
-			bson_append_binary(bson, key, key_len, intern->type, (const uint8_t*) intern->data, (uint32_t) intern->data_len);
+			bson_append_binary(bson, key, key_len, intern->type, (const uint8_t*) ZSTR_VAL(intern->data), (uint32_t) ZSTR_LEN(intern->data));
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_decimal128_ce)) {
-			php_phongo_decimal128_t* intern = Z_DECIMAL128_OBJ_P(object);
 
-			bson_append_decimal128(bson, key, key_len, &intern->decimal);
+		case PHONGO_BSON_ENCODE_DECIMAL128:
+			bson_append_decimal128(bson, key, key_len, &Z_DECIMAL128_OBJ_P(object)->decimal);
 			return;
-		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_int64_ce)) {
-			php_phongo_int64_t* intern = Z_INT64_OBJ_P(object);
 
-			bson_append_int64(bson, key, key_len, intern->integer);
+		case PHONGO_BSON_ENCODE_INT64:
+			bson_append_int64(bson, key, key_len, Z_INT64_OBJ_P(object)->integer);
 			return;
-		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_regex_ce)) {
+
+		case PHONGO_BSON_ENCODE_REGEX: {
 			php_phongo_regex_t* intern = Z_REGEX_OBJ_P(object);
 
 			bson_append_regex(bson, key, key_len, intern->pattern, intern->flags);
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_javascript_ce)) {
+
+		case PHONGO_BSON_ENCODE_JAVASCRIPT: {
 			php_phongo_javascript_t* intern = Z_JAVASCRIPT_OBJ_P(object);
 
 			if (intern->scope) {
@@ -252,23 +430,24 @@ static void php_phongo_bson_append_object(bson_t* bson, php_phongo_field_path* f
 			}
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_timestamp_ce)) {
+
+		case PHONGO_BSON_ENCODE_TIMESTAMP: {
 			php_phongo_timestamp_t* intern = Z_TIMESTAMP_OBJ_P(object);
 
 			bson_append_timestamp(bson, key, key_len, intern->timestamp, intern->increment);
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_maxkey_ce)) {
+
+		case PHONGO_BSON_ENCODE_MAXKEY:
 			bson_append_maxkey(bson, key, key_len);
 			return;
-		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_minkey_ce)) {
+
+		case PHONGO_BSON_ENCODE_MINKEY:
 			bson_append_minkey(bson, key, key_len);
 			return;
-		}
 
 		/* Deprecated types */
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_dbpointer_ce)) {
+		case PHONGO_BSON_ENCODE_DBPOINTER: {
 			bson_oid_t              oid;
 			php_phongo_dbpointer_t* intern = Z_DBPOINTER_OBJ_P(object);
 
@@ -276,48 +455,50 @@ static void php_phongo_bson_append_object(bson_t* bson, php_phongo_field_path* f
 			bson_append_dbpointer(bson, key, key_len, intern->ref, &oid);
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_symbol_ce)) {
+
+		case PHONGO_BSON_ENCODE_SYMBOL: {
 			php_phongo_symbol_t* intern = Z_SYMBOL_OBJ_P(object);
 
 			bson_append_symbol(bson, key, key_len, intern->symbol, intern->symbol_len);
 			return;
 		}
-		if (instanceof_function(Z_OBJCE_P(object), php_phongo_undefined_ce)) {
+
+		case PHONGO_BSON_ENCODE_UNDEFINED:
 			bson_append_undefined(bson, key, key_len);
 			return;
-		}
 
-		phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Unexpected %s instance: %s", ZSTR_VAL(php_phongo_type_ce->name), ZSTR_VAL(Z_OBJCE_P(object)->name));
-		return;
-	}
-
-	if (Z_TYPE_P(object) == IS_OBJECT && Z_OBJCE_P(object)->ce_flags & ZEND_ACC_ENUM) {
-		if (Z_OBJCE_P(object)->enum_backing_type == IS_UNDEF) {
-			char* path_string = php_phongo_field_path_as_string(field_path);
-			phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Non-backed enum %s cannot be serialized for field path \"%s\"", ZSTR_VAL(Z_OBJCE_P(object)->name), path_string);
-			efree(path_string);
+		case PHONGO_BSON_ENCODE_UNEXPECTED_TYPE:
+			phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Unexpected %s instance: %s", ZSTR_VAL(php_phongo_type_ce->name), ZSTR_VAL(Z_OBJCE_P(object)->name));
 			return;
-		}
 
-		php_phongo_bson_append(bson, field_path, flags, key, key_len, zend_enum_fetch_case_value(Z_OBJ_P(object)));
-		return;
-	}
+		case PHONGO_BSON_ENCODE_ENUM:
+			if (Z_OBJCE_P(object)->enum_backing_type == IS_UNDEF) {
+				char* path_string = php_phongo_bson_encode_frame_path(frame);
+				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Non-backed enum %s cannot be serialized for field path \"%s\"", ZSTR_VAL(Z_OBJCE_P(object)->name), path_string);
+				efree(path_string);
+				return;
+			}
 
-	{
-		bson_t child;
+			php_phongo_bson_append(bson, frame->parent, flags, key, key_len, zend_enum_fetch_case_value(Z_OBJ_P(object)));
+			return;
 
-		bson_append_document_begin(bson, key, key_len, &child);
-		php_phongo_zval_to_bson_internal(object, field_path, flags, &child, NULL);
-		bson_append_document_end(bson, &child);
+		case PHONGO_BSON_ENCODE_PROPERTIES:
+		default: {
+			bson_t child;
+
+			bson_append_document_begin(bson, key, key_len, &child);
+			php_phongo_zval_to_bson_internal(object, frame, flags, &child, NULL);
+			bson_append_document_end(bson, &child);
+		}
 	}
 }
 
 /* Appends the zval argument to the BSON document. If the argument is an object,
  * or an array that should be serialized as an embedded document, this function
  * will defer to php_phongo_bson_append_object(). */
-static void php_phongo_bson_append(bson_t* bson, php_phongo_field_path* field_path, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* entry)
+static void php_phongo_bson_append(bson_t* bson, const php_phongo_bson_encode_frame* parent, php_phongo_bson_flags_t flags, const char* key, long key_len, zval* entry)
 {
-	php_phongo_field_path_write_item_at_current_level(field_path, key);
+	php_phongo_bson_encode_frame frame = { parent, key };
 
 try_again:
 	switch (Z_TYPE_P(entry)) {
@@ -341,10 +522,10 @@ try_again:
 			break;
 
 		case IS_STRING:
-			if (bson_utf8_validate(Z_STRVAL_P(entry), Z_STRLEN_P(entry), true)) {
+			if (php_phongo_utf8_validate(Z_STR_P(entry))) {
 				bson_append_utf8(bson, key, key_len, Z_STRVAL_P(entry), Z_STRLEN_P(entry));
 			} else {
-				char* path_string = php_phongo_field_path_as_string(field_path);
+				char* path_string = php_phongo_bson_encode_frame_path(&frame);
 				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Detected invalid UTF-8 for field path \"%s\": %s", path_string, Z_STRVAL_P(entry));
 				efree(path_string);
 			}
@@ -356,17 +537,14 @@ try_again:
 				HashTable* tmp_ht = HASH_OF(entry);
 
 				if (!php_phongo_zend_hash_apply_protection_begin(tmp_ht)) {
-					char* path_string = php_phongo_field_path_as_string(field_path);
+					char* path_string = php_phongo_bson_encode_frame_path(&frame);
 					phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Detected recursion for field path \"%s\"", path_string);
 					efree(path_string);
 					break;
 				}
 
 				bson_append_array_begin(bson, key, key_len, &child);
-				php_phongo_field_path_write_type_at_current_level(field_path, PHONGO_FIELD_PATH_ITEM_ARRAY);
-				field_path->size++;
-				php_phongo_zval_to_bson_internal(entry, field_path, flags, &child, NULL);
-				field_path->size--;
+				php_phongo_zval_to_bson_internal(entry, &frame, flags, &child, NULL);
 				bson_append_array_end(bson, &child);
 
 				php_phongo_zend_hash_apply_protection_end(tmp_ht);
@@ -375,26 +553,38 @@ try_again:
 			PHONGO_BREAK_INTENTIONALLY_MISSING
 
 		case IS_OBJECT: {
-			HashTable* tmp_ht = HASH_OF(entry);
+			/* Plain objects are guarded against recursion on the object itself,
+			 * since fetching their properties HashTable would defeat encoding
+			 * their declared property slots directly. Other objects are guarded
+			 * on their properties HashTable, so that the object is not marked
+			 * as recursive while user code such as bsonSerialize() runs. */
+			zend_object* object  = Z_OBJ_P(entry);
+			HashTable*   tmp_ht  = NULL;
+			bool         recurse = false;
+
+			if (php_phongo_bson_get_encode_strategy(object->ce) == PHONGO_BSON_ENCODE_PROPERTIES) {
+				if (!(recurse = GC_IS_RECURSIVE(object))) {
+					GC_PROTECT_RECURSION(object);
+				}
+			} else {
+				tmp_ht  = HASH_OF(entry);
+				recurse = !php_phongo_zend_hash_apply_protection_begin(tmp_ht);
+			}
 
-			if (!php_phongo_zend_hash_apply_protection_begin(tmp_ht)) {
-				char* path_string = php_phongo_field_path_as_string(field_path);
+			if (recurse) {
+				char* path_string = php_phongo_bson_encode_frame_path(&frame);
 				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Detected recursion for field path \"%s\"", path_string);
 				efree(path_string);
 				break;
 			}
 
-			if (Z_TYPE_P(entry) == IS_OBJECT && instanceof_function(Z_OBJCE_P(entry), php_phongo_packedarray_ce)) {
-				php_phongo_field_path_write_type_at_current_level(field_path, PHONGO_FIELD_PATH_ITEM_ARRAY);
+			php_phongo_bson_append_object(bson, &frame, flags, key, key_len, entry);
+
+			if (tmp_ht) {
+				php_phongo_zend_hash_apply_protection_end(tmp_ht);
 			} else {
-				php_phongo_field_path_write_type_at_current_level(field_path, PHONGO_FIELD_PATH_ITEM_DOCUMENT);
+				GC_UNPROTECT_RECURSION(object);
 			}
-
-			field_path->size++;
-			php_phongo_bson_append_object(bson, field_path, flags, key, key_len, entry);
-			field_path->size--;
-
-			php_phongo_zend_hash_apply_protection_end(tmp_ht);
 			break;
 		}
 
@@ -403,35 +593,82 @@ try_again:
 			goto try_again;
 
 		default: {
-			char* path_string = php_phongo_field_path_as_string(field_path);
+			char* path_string = php_phongo_bson_encode_frame_path(&frame);
 			phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Detected unsupported PHP type for field path \"%s\": %d (%s)", path_string, Z_TYPE_P(entry), zend_get_type_by_const(Z_TYPE_P(entry)));
 			efree(path_string);
 		}
 	}
 }
 
-/* This is based on bson_copy_to_excluding_noinit() and is necessary because
- * bson_copy_to() cannot be used with a bson_t allocated with bson_new(). */
+/* Appends all fields of the source document to the destination document. This
+ * is necessary because bson_copy_to() cannot be used with a bson_t allocated
+ * with bson_new(). The fields are copied with a single append of the source
+ * document's data, rather than one append per field. */
 static void phongo_bson_copy_to_noinit(const bson_t* src, bson_t* dst)
 {
-	bson_iter_t iter;
+	if (!bson_concat(dst, src)) {
+		/* This should only be possible if the resulting document would exceed
+		 * the maximum BSON document size. */
+		phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Error copying fields from source document");
+	}
+}
 
-	if (bson_iter_init(&iter, src)) {
-		while (bson_iter_next(&iter)) {
-			if (!bson_append_iter(dst, NULL, 0, &iter)) {
-				/* This should not be able to happen since we are copying from
-				 * within a valid bson_t. */
-				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Error copying \"%s\" field from source document", bson_iter_key(&iter));
-				return;
-			}
+/* Appends the initialized public properties of an object by reading its
+ * property slots directly. This avoids building the properties HashTable and
+ * filtering out protected and private properties by their mangled names, but is
+ * only possible for objects that use the standard get_properties() handler and
+ * do not have dynamic properties. Returns false if the object does not qualify,
+ * in which case nothing was appended. */
+static bool php_phongo_bson_append_declared_properties(bson_t* bson, const php_phongo_bson_encode_frame* parent, php_phongo_bson_flags_t* flags, zend_object* object)
+{
+	zend_class_entry* ce = object->ce;
+	int               i;
+
+	if (object->properties || object->handlers->get_properties != zend_std_get_properties) {
+		return false;
+	}
+
+	if (ce->default_properties_count && !ce->properties_info_table) {
+		return false;
+	}
+
+#if PHP_VERSION_ID >= 80400
+	/* Reading the properties of a lazy object requires initializing it */
+	if (zend_object_is_lazy(object)) {
+		return false;
+	}
+#endif
+
+	for (i = 0; i < ce->default_properties_count; i++) {
+		zend_property_info* prop_info = ce->properties_info_table[i];
+		zval*               value;
+
+		if (!prop_info || !(prop_info->flags & ZEND_ACC_PUBLIC)) {
+			continue;
 		}
+
+		value = OBJ_PROP(object, prop_info->offset);
+
+		/* Skip uninitialized typed properties */
+		if (Z_TYPE_P(value) == IS_UNDEF) {
+			continue;
+		}
+
+		if (*flags & PHONGO_BSON_ADD_ID && zend_string_equals_literal(prop_info->name, "_id")) {
+			*flags &= ~PHONGO_BSON_ADD_ID;
+		}
+
+		php_phongo_bson_append(bson, parent, *flags & ~PHONGO_BSON_ADD_ID, ZSTR_VAL(prop_info->name), ZSTR_LEN(prop_info->name), value);
 	}
+
+	return true;
 }
 
-static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path* field_path, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out)
+static void php_phongo_zval_to_bson_internal(zval* data, const php_phongo_bson_encode_frame* parent, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out)
 {
-	HashTable* ht_data = NULL;
-	zval       obj_data;
+	HashTable*                      ht_data = NULL;
+	zval                            obj_data;
+	php_phongo_bson_encode_strategy strategy;
 
 	/* If we will be encoding a class that may contain protected and private
 	 * properties, we'll need to filter them out later. */
@@ -446,8 +683,10 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 
 	switch (Z_TYPE_P(data)) {
 		case IS_OBJECT:
+			strategy = php_phongo_bson_get_encode_strategy(Z_OBJCE_P(data));
+
 			/* Short-circuit MongoDB\BSON\Document and MongoDB\BSON\PackedArray instances - copy the data */
-			if (instanceof_function(Z_OBJCE_P(data), php_phongo_document_ce)) {
+			if (strategy == PHONGO_BSON_ENCODE_DOCUMENT) {
 				php_phongo_document_t* intern = Z_DOCUMENT_OBJ_P(data);
 				bson_iter_t            iter;
 
@@ -461,10 +700,10 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 				goto done;
 			}
 
-			if (instanceof_function(Z_OBJCE_P(data), php_phongo_packedarray_ce)) {
+			if (strategy == PHONGO_BSON_ENCODE_PACKEDARRAY) {
 				/* If we are at the root-level, PackedArray instances should be
 				 * prohibited unless PHONGO_BSON_ALLOW_ROOT_ARRAY is set. */
-				bool is_root_level = (field_path->size == 0);
+				bool is_root_level = (parent == NULL);
 
 				if (is_root_level && !(flags & PHONGO_BSON_ALLOW_ROOT_ARRAY)) {
 					phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "%s cannot be serialized as a root document", ZSTR_VAL(Z_OBJCE_P(data)->name));
@@ -480,7 +719,7 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 
 			/* For any MongoDB\BSON\Serializable, invoke the bsonSerialize method
 			 * and work with the result. */
-			if (instanceof_function(Z_OBJCE_P(data), php_phongo_serializable_ce)) {
+			if (strategy == PHONGO_BSON_ENCODE_SERIALIZABLE || strategy == PHONGO_BSON_ENCODE_PERSISTABLE) {
 				zend_call_method_with_0_params(Z_OBJ_P(data), NULL, NULL, BSON_SERIALIZE_FUNC_NAME, &obj_data);
 
 				if (Z_ISUNDEF(obj_data)) {
@@ -494,7 +733,7 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 					goto cleanup;
 				}
 
-				if (instanceof_function(Z_OBJCE_P(data), php_phongo_persistable_ce)) {
+				if (strategy == PHONGO_BSON_ENCODE_PERSISTABLE) {
 					bson_append_binary(bson, PHONGO_ODM_FIELD_NAME, -1, 0x80, (const uint8_t*) Z_OBJCE_P(data)->name->val, Z_OBJCE_P(data)->name->len);
 					/* Ensure that we ignore an existing key with the same name
 					 * if one exists in the bsonSerialize() return value. */
@@ -503,7 +742,7 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 
 				// If bsonSerialize() returns a BSON document or packedArray instance, recurse to copy data over directly
 				if (Z_TYPE(obj_data) == IS_OBJECT && (instanceof_function(Z_OBJCE(obj_data), php_phongo_document_ce) || instanceof_function(Z_OBJCE(obj_data), php_phongo_packedarray_ce))) {
-					php_phongo_zval_to_bson_internal(&obj_data, field_path, flags, bson, bson_out);
+					php_phongo_zval_to_bson_internal(&obj_data, parent, flags, bson, bson_out);
 
 					goto done;
 				}
@@ -516,7 +755,7 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 			/* For the error handling that follows, we can safely assume that we
 			 * are at the root level, since php_phongo_bson_append_object would
 			 * have already been called for a non-root level. */
-			if (Z_OBJCE_P(data)->ce_flags & ZEND_ACC_ENUM) {
+			if (strategy == PHONGO_BSON_ENCODE_ENUM) {
 				phongo_throw_exception(PHONGO_ERROR_UNEXPECTED_VALUE, "Enum %s cannot be serialized as a root element", ZSTR_VAL(Z_OBJCE_P(data)->name));
 				return;
 			}
@@ -526,6 +765,10 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 				return;
 			}
 
+			if (php_phongo_bson_append_declared_properties(bson, parent, &flags, Z_OBJ_P(data))) {
+				goto done;
+			}
+
 			ht_data                 = Z_OBJ_HT_P(data)->get_properties(Z_OBJ_P(data));
 			ht_data_from_properties = true;
 			break;
@@ -577,7 +820,7 @@ static void php_phongo_zval_to_bson_internal(zval* data, php_phongo_field_path*
 				zend_string_addref(string_key);
 			}
 
-			php_phongo_bson_append(bson, field_path, flags & ~PHONGO_BSON_ADD_ID, ZSTR_VAL(string_key), strlen(ZSTR_VAL(string_key)), value);
+			php_phongo_bson_append(bson, parent, flags & ~PHONGO_BSON_ADD_ID, ZSTR_VAL(string_key), strlen(ZSTR_VAL(string_key)), value);
 
 			zend_string_release(string_key);
 		}
@@ -617,11 +860,64 @@ cleanup:
  * will be used. */
 void php_phongo_zval_to_bson(zval* data, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out)
 {
-	php_phongo_field_path* field_path = php_phongo_field_path_alloc(false);
+	php_phongo_zval_to_bson_internal(data, NULL, flags, bson, bson_out);
+}
+
+/* Realloc function for a bson_writer_t whose buffer is the value of a
+ * zend_string. The string is reallocated as a whole, so that the encoded data
+ * never needs to be copied into a separate string. */
+static void* php_phongo_bson_string_realloc(void* mem, size_t num_bytes, void* ctx)
+{
+	zend_string* str = (zend_string*) ((char*) mem - XtOffsetOf(zend_string, val));
+
+	str = zend_string_realloc(str, num_bytes, 0);
 
-	php_phongo_zval_to_bson_internal(data, field_path, flags, bson, bson_out);
+	return ZSTR_VAL(str);
+}
+
+/* Converts the array or object argument to a BSON document that is encoded
+ * directly into a zend_string, which can be returned to PHP as-is. Returns
+ * NULL if an exception was thrown during encoding. */
+zend_string* php_phongo_zval_to_bson_string(zval* data, php_phongo_bson_flags_t flags)
+{
+	zend_string*   str;
+	bson_writer_t* writer;
+	bson_t*        bson;
+	uint8_t*       buf;
+	size_t         buf_len = PHONGO_BSON_STRING_INITIAL_SIZE;
+	size_t         length;
+
+	str    = zend_string_alloc(buf_len, 0);
+	buf    = (uint8_t*) ZSTR_VAL(str);
+	writer = bson_writer_new(&buf, &buf_len, 0, php_phongo_bson_string_realloc, NULL);
+
+	bson_writer_begin(writer, &bson);
+	php_phongo_zval_to_bson(data, flags, bson, NULL);
+
+	if (EG(exception)) {
+		bson_writer_rollback(writer);
+		bson_writer_destroy(writer);
+		zend_string_efree((zend_string*) ((char*) buf - XtOffsetOf(zend_string, val)));
+
+		return NULL;
+	}
+
+	bson_writer_end(writer);
+	length = bson_writer_get_length(writer);
+	bson_writer_destroy(writer);
+
+	/* The buffer may have moved while encoding. Since the string was allocated
+	 * with one byte more than buf_len, there is room for the terminator. */
+	str                   = (zend_string*) ((char*) buf - XtOffsetOf(zend_string, val));
+	ZSTR_LEN(str)         = length;
+	ZSTR_VAL(str)[length] = '\0';
+
+	/* Release unused capacity of larger buffers */
+	if (buf_len - length > PHONGO_BSON_STRING_INITIAL_SIZE) {
+		str = zend_string_truncate(str, length, 0);
+	}
 
-	php_phongo_field_path_free(field_path);
+	return str;
 }
 
 static void phongo_zval_to_bson_value_ex(zval* data, php_phongo_bson_flags_t flags, bson_value_t* value)
@@ -28,7 +28,11 @@ typedef enum {
 	PHONGO_BSON_ALLOW_ROOT_ARRAY = (1 << 2)
 } php_phongo_bson_flags_t;
 
+/* Initial capacity of strings returned by php_phongo_zval_to_bson_string() */
+#define PHONGO_BSON_STRING_INITIAL_SIZE 128
+
 void php_phongo_zval_to_bson(zval* data, php_phongo_bson_flags_t flags, bson_t* bson, bson_t** bson_out);
+zend_string* php_phongo_zval_to_bson_string(zval* data, php_phongo_bson_flags_t flags);
 bool phongo_zval_to_bson_value(zval* data, bson_value_t* value);
 void php_phongo_bson_append_zval(bson_t* bson, const char* key, long key_len, zval* value);
 
@@ -138,6 +138,10 @@ static inline php_phongo_packedarray_t* php_packedarray_fetch_object(zend_object
 {
 	return (php_phongo_packedarray_t*) ((char*) obj - XtOffsetOf(php_phongo_packedarray_t, std));
 }
+static inline php_phongo_reader_t* php_reader_fetch_object(zend_object* obj)
+{
+	return (php_phongo_reader_t*) ((char*) obj - XtOffsetOf(php_phongo_reader_t, std));
+}
 static inline php_phongo_regex_t* php_regex_fetch_object(zend_object* obj)
 {
 	return (php_phongo_regex_t*) ((char*) obj - XtOffsetOf(php_phongo_regex_t, std));
@@ -158,6 +162,10 @@ static inline php_phongo_utcdatetime_t* php_utcdatetime_fetch_object(zend_object
 {
 	return (php_phongo_utcdatetime_t*) ((char*) obj - XtOffsetOf(php_phongo_utcdatetime_t, std));
 }
+static inline php_phongo_writer_t* php_writer_fetch_object(zend_object* obj)
+{
+	return (php_phongo_writer_t*) ((char*) obj - XtOffsetOf(php_phongo_writer_t, std));
+}
 static inline php_phongo_commandfailedevent_t* php_commandfailedevent_fetch_object(zend_object* obj)
 {
 	return (php_phongo_commandfailedevent_t*) ((char*) obj - XtOffsetOf(php_phongo_commandfailedevent_t, std));
@@ -236,11 +244,13 @@ static inline php_phongo_topologyopeningevent_t* php_topologyopeningevent_fetch_
 #define Z_MINKEY_OBJ_P(zv) (php_minkey_fetch_object(Z_OBJ_P(zv)))
 #define Z_OBJECTID_OBJ_P(zv) (php_objectid_fetch_object(Z_OBJ_P(zv)))
 #define Z_PACKEDARRAY_OBJ_P(zv) (php_packedarray_fetch_object(Z_OBJ_P(zv)))
+#define Z_READER_OBJ_P(zv) (php_reader_fetch_object(Z_OBJ_P(zv)))
 #define Z_REGEX_OBJ_P(zv) (php_regex_fetch_object(Z_OBJ_P(zv)))
 #define Z_SYMBOL_OBJ_P(zv) (php_symbol_fetch_object(Z_OBJ_P(zv)))
 #define Z_TIMESTAMP_OBJ_P(zv) (php_timestamp_fetch_object(Z_OBJ_P(zv)))
 #define Z_UNDEFINED_OBJ_P(zv) (php_undefined_fetch_object(Z_OBJ_P(zv)))
 #define Z_UTCDATETIME_OBJ_P(zv) (php_utcdatetime_fetch_object(Z_OBJ_P(zv)))
+#define Z_WRITER_OBJ_P(zv) (php_writer_fetch_object(Z_OBJ_P(zv)))
 #define Z_COMMANDFAILEDEVENT_OBJ_P(zv) (php_commandfailedevent_fetch_object(Z_OBJ_P(zv)))
 #define Z_COMMANDSTARTEDEVENT_OBJ_P(zv) (php_commandstartedevent_fetch_object(Z_OBJ_P(zv)))
 #define Z_COMMANDSUCCEEDEDEVENT_OBJ_P(zv) (php_commandsucceededevent_fetch_object(Z_OBJ_P(zv)))
@@ -283,11 +293,13 @@ static inline php_phongo_topologyopeningevent_t* php_topologyopeningevent_fetch_
 #define Z_OBJ_MINKEY(zo) (php_minkey_fetch_object(zo))
 #define Z_OBJ_OBJECTID(zo) (php_objectid_fetch_object(zo))
 #define Z_OBJ_PACKEDARRAY(zo) (php_packedarray_fetch_object(zo))
+#define Z_OBJ_READER(zo) (php_reader_fetch_object(zo))
 #define Z_OBJ_REGEX(zo) (php_regex_fetch_object(zo))
 #define Z_OBJ_SYMBOL(zo) (php_symbol_fetch_object(zo))
 #define Z_OBJ_TIMESTAMP(zo) (php_timestamp_fetch_object(zo))
 #define Z_OBJ_UNDEFINED(zo) (php_undefined_fetch_object(zo))
 #define Z_OBJ_UTCDATETIME(zo) (php_utcdatetime_fetch_object(zo))
+#define Z_OBJ_WRITER(zo) (php_writer_fetch_object(zo))
 #define Z_OBJ_COMMANDFAILEDEVENT(zo) (php_commandfailedevent_fetch_object(zo))
 #define Z_OBJ_COMMANDSTARTEDEVENT(zo) (php_commandstartedevent_fetch_object(zo))
 #define Z_OBJ_COMMANDSUCCEEDEDEVENT(zo) (php_commandsucceededevent_fetch_object(zo))
@@ -341,6 +353,7 @@ extern zend_class_entry* php_phongo_bulkwriteexception_ce;
 extern zend_class_entry* php_phongo_type_ce;
 extern zend_class_entry* php_phongo_persistable_ce;
 extern zend_class_entry* php_phongo_unserializable_ce;
+extern zend_class_entry* php_phongo_hydratable_ce;
 extern zend_class_entry* php_phongo_serializable_ce;
 extern zend_class_entry* php_phongo_binary_ce;
 extern zend_class_entry* php_phongo_document_ce;
@@ -353,11 +366,13 @@ extern zend_class_entry* php_phongo_maxkey_ce;
 extern zend_class_entry* php_phongo_minkey_ce;
 extern zend_class_entry* php_phongo_objectid_ce;
 extern zend_class_entry* php_phongo_packedarray_ce;
+extern zend_class_entry* php_phongo_reader_ce;
 extern zend_class_entry* php_phongo_regex_ce;
 extern zend_class_entry* php_phongo_symbol_ce;
 extern zend_class_entry* php_phongo_timestamp_ce;
 extern zend_class_entry* php_phongo_undefined_ce;
 extern zend_class_entry* php_phongo_utcdatetime_ce;
+extern zend_class_entry* php_phongo_writer_ce;
 
 extern zend_class_entry* php_phongo_binary_interface_ce;
 extern zend_class_entry* php_phongo_decimal128_interface_ce;
@@ -397,7 +412,9 @@ extern void php_phongo_javascript_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_maxkey_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_minkey_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_objectid_init_ce(INIT_FUNC_ARGS);
+extern void php_phongo_hydratable_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_persistable_init_ce(INIT_FUNC_ARGS);
+extern void php_phongo_reader_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_regex_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_serializable_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_symbol_init_ce(INIT_FUNC_ARGS);
@@ -406,6 +423,7 @@ extern void php_phongo_type_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_undefined_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_unserializable_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_utcdatetime_init_ce(INIT_FUNC_ARGS);
+extern void php_phongo_writer_init_ce(INIT_FUNC_ARGS);
 
 extern void php_phongo_binary_interface_init_ce(INIT_FUNC_ARGS);
 extern void php_phongo_decimal128_interface_init_ce(INIT_FUNC_ARGS);
@@ -52,21 +52,34 @@ typedef struct {
 	zend_object std;
 } php_phongo_command_t;
 
-typedef struct {
-	mongoc_cursor_t*      cursor;
-	zval                  manager;
-	int                   created_by_pid;
-	uint32_t              server_id;
-	bool                  advanced;
-	php_phongo_bson_state visitor_data;
-	long                  current;
-	char*                 database;
-	char*                 collection;
-	zval                  query;
-	zval                  command;
-	zval                  read_preference;
-	zval                  session;
-	zend_object           std;
+/* Bounds and observed result sizes for a cursor's adaptive batch size. A zero
+ * target_bytes disables adaptation. */
+typedef struct {
+	uint32_t target_bytes;
+	uint32_t min_batch_size;
+	uint32_t max_batch_size;
+	uint32_t batch_size;
+	uint64_t observed_bytes;
+	uint64_t observed_documents;
+} php_phongo_cursor_adaptive_batch_t;
+
+typedef struct {
+	mongoc_cursor_t*                   cursor;
+	zval                               manager;
+	int                                created_by_pid;
+	uint32_t                           server_id;
+	bool                               advanced;
+	bool                               current_deferred;
+	php_phongo_bson_state              visitor_data;
+	long                               current;
+	char*                              database;
+	char*                              collection;
+	zval                               query;
+	zval                               command;
+	zval                               read_preference;
+	zval                               session;
+	php_phongo_cursor_adaptive_batch_t adaptive_batch;
+	zend_object                        std;
 } php_phongo_cursor_t;
 
 typedef struct {
@@ -170,23 +183,60 @@ typedef struct {
 } php_phongo_writeresult_t;
 
 typedef struct {
-	char*       data;
-	int         data_len;
-	uint8_t     type;
-	HashTable*  properties;
-	zend_object std;
+	bson_reader_t*        reader;
+	zval                  stream;
+	size_t                bytes_read;
+	bool                  started;
+	zend_long             key;
+	php_phongo_bson_state visitor_data;
+	zend_object           std;
+} php_phongo_reader_t;
+
+typedef struct {
+	bson_writer_t* writer;
+	uint8_t*       buf;
+	size_t         buf_len;
+	size_t         buffer_size;
+	zval           stream;
+	zend_object    std;
+} php_phongo_writer_t;
+
+typedef struct {
+	zend_string* data;
+	uint8_t      type;
+	HashTable*   properties;
+	zend_object  std;
 } php_phongo_binary_t;
 
+/* Byte offsets of the elements of a PackedArray, in order. Like the Document
+ * key index, this is shared by clones of the same data. */
 typedef struct {
-	bson_t*     bson;
-	HashTable*  properties;
-	zend_object std;
+	uint32_t* offsets;
+	uint32_t  count;
+	uint32_t  ref_count;
+} php_phongo_packedarray_index_t;
+
+typedef struct {
+	bson_t*                         bson;
+	php_phongo_packedarray_index_t* index;
+	HashTable*                      properties;
+	zend_object                     std;
 } php_phongo_packedarray_t;
 
+/* Maps the keys of a Document to the byte offsets of their elements. Offsets
+ * are relative to the start of the BSON data, so the index remains valid for
+ * clones and detached copies of the same data and is shared between them. */
 typedef struct {
-	bson_t*     bson;
-	HashTable*  properties;
-	zend_object std;
+	HashTable offsets;
+	uint32_t  ref_count;
+} php_phongo_document_index_t;
+
+typedef struct {
+	bson_t*                      bson;
+	bool                         borrowed;
+	php_phongo_document_index_t* index;
+	HashTable*                   properties;
+	zend_object                  std;
 } php_phongo_document_t;
 
 typedef struct {
@@ -240,7 +290,7 @@ typedef struct {
 
 typedef struct {
 	bool        initialized;
-	char        oid[25];
+	bson_oid_t  oid;
 	HashTable*  properties;
 	zend_object std;
 } php_phongo_objectid_t;
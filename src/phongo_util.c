@@ -19,6 +19,10 @@
 
 #include <php.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "phongo_util.h"
 
 const char* php_phongo_bson_type_to_string(bson_type_t type)
@@ -140,3 +144,64 @@ bool phongo_split_namespace(const char* namespace, char** dbname, char** cname)
 
 	return true;
 }
+
+/* Returns the length of the leading run of ASCII bytes in a buffer. This
+ * checks 16 bytes at a time with SSE2 where available, and otherwise one word
+ * at a time. */
+static size_t php_phongo_ascii_prefix_len(const char* data, size_t len)
+{
+	size_t i = 0;
+
+#ifdef __SSE2__
+	for (; i + 16 <= len; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*) (data + i));
+
+		if (_mm_movemask_epi8(chunk)) {
+			break;
+		}
+	}
+#else
+	for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+		uint64_t chunk;
+
+		memcpy(&chunk, data + i, sizeof(uint64_t));
+
+		if (chunk & UINT64_C(0x8080808080808080)) {
+			break;
+		}
+	}
+#endif
+
+	while (i < len && !(data[i] & 0x80)) {
+		i++;
+	}
+
+	return i;
+}
+
+/* Checks whether a string is valid UTF-8 (allowing null bytes). Strings that
+ * PHP has already marked as valid UTF-8 are not checked again, and strings
+ * that pass validation are marked so that later checks are free. Only the
+ * part following the leading run of ASCII bytes is passed to libbson's
+ * byte-by-byte validator. */
+bool php_phongo_utf8_validate(zend_string* str)
+{
+	size_t ascii_len;
+
+	if (GC_FLAGS(str) & IS_STR_VALID_UTF8) {
+		return true;
+	}
+
+	ascii_len = php_phongo_ascii_prefix_len(ZSTR_VAL(str), ZSTR_LEN(str));
+
+	if (ascii_len < ZSTR_LEN(str) && !bson_utf8_validate(ZSTR_VAL(str) + ascii_len, ZSTR_LEN(str) - ascii_len, true)) {
+		return false;
+	}
+
+	/* Interned strings may reside in read-only shared memory */
+	if (!ZSTR_IS_INTERNED(str)) {
+		GC_ADD_FLAGS(str, IS_STR_VALID_UTF8);
+	}
+
+	return true;
+}
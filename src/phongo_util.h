@@ -28,4 +28,6 @@ bool php_phongo_parse_int64(int64_t* retval, const char* data, size_t data_len);
 
 bool phongo_split_namespace(const char* namespace, char** dbname, char** cname);
 
+bool php_phongo_utf8_validate(zend_string* str);
+
 #endif /* PHONGO_UTIL_H */
@@ -0,0 +1,27 @@
+--TEST--
+MongoDB\BSON\Binary shares its data string instead of copying it
+--FILE--
+<?php
+
+$data = str_repeat('x', 1024 * 1024);
+
+$before = memory_get_usage();
+
+$binary = new MongoDB\BSON\Binary($data);
+$clone = clone $binary;
+$strings = [$binary->getData(), (string) $binary, $clone->getData()];
+
+var_dump(memory_get_usage() - $before < 1024 * 1024);
+var_dump($strings[0] === $data);
+
+$document = MongoDB\BSON\Document::fromPHP(['binary' => $binary]);
+var_dump($document->get('binary')->getData() === $data);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+===DONE===
@@ -0,0 +1,39 @@
+--TEST--
+MongoDB\BSON\Document::extract() returns values for multiple paths
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'a' => ['b' => ['c' => 'foo', 'd' => [1, 2, 3]]],
+    'n' => null,
+    'x' => 1,
+]);
+
+var_dump($document->extract(['a.b.c', 'a.b.d.0', 'n', 'missing', 'x.y', 'x']));
+var_dump($document->extract([]));
+
+echo throws(function() use ($document) {
+    $document->extract(['x', 1]);
+}, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+array(4) {
+  ["a.b.c"]=>
+  string(3) "foo"
+  ["a.b.d.0"]=>
+  int(1)
+  ["n"]=>
+  NULL
+  ["x"]=>
+  int(1)
+}
+array(0) {
+}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected path to be a string, int given
+===DONE===
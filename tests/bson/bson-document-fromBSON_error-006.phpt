@@ -0,0 +1,47 @@
+--TEST--
+MongoDB\BSON\Document::fromBSON(): BSON decoding exceptions report the path of the enclosing document or array
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$tests = [
+    // Invalid UTF-8 character in embedded document's field name after a valid field
+    str_replace('INVALID!', "INVALID\xFE", fromPHP(['a' => 1, 'foo' => ['x' => 1, 'INVALID!' => 'bar']])),
+    // Invalid UTF-8 character in string within array field after a valid element
+    str_replace('INVALID!', "INVALID\xFE", fromPHP(['foo' => ['bar', 'INVALID!']])),
+];
+
+foreach ($tests as $bson) {
+    echo throws(function() use ($bson) {
+        MongoDB\BSON\Document::fromBSON($bson)->toPHP();
+    }, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+
+    echo throws(function() use ($bson) {
+        MongoDB\BSON\Document::fromBSON($bson)->toPHP(['root' => 'array', 'document' => 'array', 'array' => 'object']);
+    }, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+}
+
+// Unknown BSON type for the second element of an array
+$bson = fromPHP(['hello' => ['a', 'world']]);
+$bson[24] = chr(0x42);
+
+echo throws(function() use ($bson) {
+    MongoDB\BSON\Document::fromBSON($bson)->toPHP();
+}, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected corrupt BSON data for field path 'foo' at offset 0
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected corrupt BSON data for field path 'foo' at offset 0
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected corrupt BSON data for field path 'foo' at offset 0
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected corrupt BSON data for field path 'foo' at offset 0
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected unknown BSON type 0x42 for field path "hello.1". Are you using the latest driver?
+===DONE===
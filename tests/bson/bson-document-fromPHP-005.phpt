@@ -0,0 +1,44 @@
+--TEST--
+MongoDB\BSON\Document::fromPHP(): UTF-8 validation of strings
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$ascii = str_repeat('a', 40);
+$valid = [
+    'ascii' => $ascii,
+    'multibyte' => $ascii . "\u{e9}\u{20ac}\u{1f600}" . $ascii,
+    'null' => $ascii . "\0" . $ascii,
+];
+
+// Encode twice, as strings that passed validation are flagged as valid UTF-8
+for ($i = 0; $i < 2; $i++) {
+    var_dump(MongoDB\BSON\Document::fromPHP($valid)->toPHP(['root' => 'array']) === $valid);
+}
+
+$invalid = [
+    'short' => "\xff",
+    'after ASCII' => $ascii . "\xc3\x28",
+    'truncated' => $ascii . "\xe2\x82",
+];
+
+foreach ($invalid as $field => $string) {
+    echo throws(function() use ($field, $string) {
+        MongoDB\BSON\Document::fromPHP([$field => $string]);
+    }, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+bool(true)
+bool(true)
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "short": %s
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "after ASCII": %s
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "truncated": %s
+===DONE===
@@ -0,0 +1,65 @@
+--TEST--
+MongoDB\BSON\Document::fromPHP(): Encoding declared properties and prebuilt BSON returned by bsonSerialize()
+--FILE--
+<?php
+
+#[AllowDynamicProperties]
+class MyClass
+{
+    public $a = 1;
+    protected $b = 2;
+    private $c = 3;
+    public int $uninitialized;
+    public ?string $d = 'd';
+}
+
+class MyChild extends MyClass
+{
+    public $e = ['x' => 1];
+    private $f = 4;
+}
+
+class MyDocument implements MongoDB\BSON\Serializable
+{
+    public function bsonSerialize(): MongoDB\BSON\Document
+    {
+        return MongoDB\BSON\Document::fromPHP(['x' => 1, 'y' => ['z' => 2]]);
+    }
+}
+
+class MyPackedArray implements MongoDB\BSON\Serializable
+{
+    public function bsonSerialize(): MongoDB\BSON\PackedArray
+    {
+        return MongoDB\BSON\PackedArray::fromPHP([1, 2, 3]);
+    }
+}
+
+echo MongoDB\BSON\Document::fromPHP(new MyClass())->toRelaxedExtendedJSON(), "\n";
+echo MongoDB\BSON\Document::fromPHP(new MyChild())->toRelaxedExtendedJSON(), "\n";
+
+// Objects with dynamic properties
+$object = new MyClass();
+$object->uninitialized = 5;
+$object->dynamic = 6;
+echo MongoDB\BSON\Document::fromPHP($object)->toRelaxedExtendedJSON(), "\n";
+
+// Iterating properties creates the properties table
+$object = new MyChild();
+foreach ($object as $value) {}
+echo MongoDB\BSON\Document::fromPHP($object)->toRelaxedExtendedJSON(), "\n";
+
+echo MongoDB\BSON\Document::fromPHP(['document' => new MyDocument(), 'array' => new MyPackedArray()])->toRelaxedExtendedJSON(), "\n";
+echo MongoDB\BSON\Document::fromPHP(new MyDocument())->toRelaxedExtendedJSON(), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+{ "a" : 1, "d" : "d" }
+{ "a" : 1, "d" : "d", "e" : { "x" : 1 } }
+{ "a" : 1, "uninitialized" : 5, "d" : "d", "dynamic" : 6 }
+{ "a" : 1, "d" : "d", "e" : { "x" : 1 } }
+{ "document" : { "x" : 1, "y" : { "z" : 2 } }, "array" : [ 1, 2, 3 ] }
+{ "x" : 1, "y" : { "z" : 2 } }
+===DONE===
@@ -0,0 +1,61 @@
+--TEST--
+MongoDB\BSON\Document::fromPHP(): Encoding declared properties of nested objects
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class Address
+{
+    public string $city = 'Berlin';
+    public ?string $zip = null;
+    public int $uninitialized;
+    private string $secret = 'hidden';
+}
+
+class Person
+{
+    public string $name = 'alice';
+    public Address $address;
+    public array $previous = [];
+    protected int $age = 42;
+
+    public function __construct()
+    {
+        $this->address = new Address();
+        $this->previous[] = new Address();
+    }
+}
+
+$person = new Person();
+$person->previous[0]->city = 'Paris';
+
+echo MongoDB\BSON\Document::fromPHP($person)->toRelaxedExtendedJSON(), "\n";
+echo MongoDB\BSON\Document::fromPHP(['people' => [$person, $person]])->toRelaxedExtendedJSON(), "\n";
+
+// The same object may appear more than once as long as it does not contain itself
+$address = new Address();
+echo MongoDB\BSON\Document::fromPHP(['a' => $address, 'b' => $address])->toRelaxedExtendedJSON(), "\n";
+
+class Node
+{
+    public ?Node $next = null;
+}
+
+echo throws(function() {
+    $node = new Node();
+    $node->next = new Node();
+    $node->next->next = $node->next;
+    MongoDB\BSON\Document::fromPHP($node);
+}, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+{ "name" : "alice", "address" : { "city" : "Berlin", "zip" : null }, "previous" : [ { "city" : "Paris", "zip" : null } ] }
+{ "people" : [ { "name" : "alice", "address" : { "city" : "Berlin", "zip" : null }, "previous" : [ { "city" : "Paris", "zip" : null } ] }, { "name" : "alice", "address" : { "city" : "Berlin", "zip" : null }, "previous" : [ { "city" : "Paris", "zip" : null } ] } ] }
+{ "a" : { "city" : "Berlin", "zip" : null }, "b" : { "city" : "Berlin", "zip" : null } }
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected recursion for field path "next.next"
+===DONE===
@@ -0,0 +1,36 @@
+--TEST--
+MongoDB\BSON\Document::fromPHP(): Nested Serializable objects are not marked as recursive during bsonSerialize()
+--FILE--
+<?php
+
+class MySerializable implements MongoDB\BSON\Serializable, JsonSerializable
+{
+    public $x = 1;
+
+    public function bsonSerialize(): array
+    {
+        var_dump($this);
+        echo json_encode($this), "\n";
+
+        return ['x' => $this->x];
+    }
+
+    public function jsonSerialize(): array
+    {
+        return ['x' => $this->x];
+    }
+}
+
+echo MongoDB\BSON\Document::fromPHP(['nested' => new MySerializable()])->toRelaxedExtendedJSON(), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+object(MySerializable)#%d (1) {
+  ["x"]=>
+  int(1)
+}
+{"x":1}
+{ "nested" : { "x" : 1 } }
+===DONE===
@@ -0,0 +1,41 @@
+--TEST--
+MongoDB\BSON\Document::fromPHP(): Field paths reported for encoding errors in nested values
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class MySerializable implements MongoDB\BSON\Serializable
+{
+    public function bsonSerialize(): array
+    {
+        return ['ok' => 1, 'bad' => "\xff"];
+    }
+}
+
+$tests = [
+    ['a' => 1, 'b' => ['x', ['c' => ['ok' => 1, 'd' => "\xff"]]]],
+    (object) ['x' => ['y' => (object) ['z' => "\xff"]]],
+    ['list' => ['x', new MySerializable()]],
+    ['first' => ['ok' => 1], 'second' => ['bad' => "\xff"]],
+];
+
+foreach ($tests as $test) {
+    echo throws(function() use ($test) {
+        MongoDB\BSON\Document::fromPHP($test);
+    }, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "b.1.c.d": %s
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "x.y.z": %s
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "list.1.bad": %s
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Detected invalid UTF-8 for field path "second.bad": %s
+===DONE===
@@ -0,0 +1,65 @@
+--TEST--
+MongoDB\BSON\Document::get() and has() repeated key access
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$data = [];
+for ($i = 0; $i < 200; $i++) {
+    $data['field' . $i] = $i;
+}
+
+$document = MongoDB\BSON\Document::fromPHP($data);
+
+$sum = 0;
+for ($i = 199; $i >= 0; $i -= 10) {
+    $sum += $document->get('field' . $i);
+}
+var_dump($sum);
+var_dump($document->has('field0'));
+var_dump($document->has('field200'));
+var_dump(isset($document['field100']));
+var_dump($document->field150);
+
+echo "\nDuplicate keys resolve to the first occurrence\n";
+$document = MongoDB\BSON\Document::fromJSON('{ "a": 1, "b": 2, "a": 3 }');
+var_dump($document->get('b'));
+var_dump($document->get('a'));
+
+echo "\nKeys containing null bytes are never found\n";
+var_dump($document->has("a\0b"));
+
+echo "\nCloned documents share the key index\n";
+$clone = clone $document;
+unset($document);
+var_dump($clone->get('a'));
+var_dump($clone->has('c'));
+
+echo throws(function() use ($clone) {
+    $clone->get('c');
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+int(2080)
+bool(true)
+bool(false)
+bool(true)
+int(150)
+
+Duplicate keys resolve to the first occurrence
+int(2)
+int(1)
+
+Keys containing null bytes are never found
+bool(false)
+
+Cloned documents share the key index
+int(1)
+bool(false)
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not find key "c" in BSON document
+===DONE===
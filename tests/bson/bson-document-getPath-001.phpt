@@ -0,0 +1,54 @@
+--TEST--
+MongoDB\BSON\Document::getPath() dotted path access
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'a' => ['b' => ['c' => 'foo', 'd' => [1, 2, ['e' => 'bar']]]],
+    'x' => 1,
+]);
+
+var_dump($document->getPath('x'));
+var_dump($document->getPath('a.b.c'));
+var_dump($document->getPath('a.b.d.1'));
+var_dump($document->getPath('a.b.d.2.e'));
+var_dump($document->getPath('a.b.d.2'));
+
+echo throws(function() use ($document) {
+    $document->getPath('a.b.missing');
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+echo throws(function() use ($document) {
+    $document->getPath('x.y');
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+echo throws(function() use ($document) {
+    $document->getPath('a.b.d.3');
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+int(1)
+string(3) "foo"
+int(2)
+string(3) "bar"
+object(MongoDB\BSON\Document)#%d (%d) {
+  ["data"]=>
+  string(24) "EAAAAAJlAAQAAABiYXIAAA=="
+  ["value"]=>
+  object(stdClass)#%d (%d) {
+    ["e"]=>
+    string(3) "bar"
+  }
+}
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not find path "a.b.missing" in BSON document
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not find path "x.y" in BSON document
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not find path "a.b.d.3" in BSON document
+===DONE===
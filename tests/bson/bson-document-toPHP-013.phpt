@@ -0,0 +1,58 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): fieldPaths precedence follows type map order for overlapping wildcard keys
+--FILE--
+<?php
+
+$bson = MongoDB\BSON\Document::fromPHP([
+    'object' => [
+        'parent1' => [
+            'child1' => ['x' => 1],
+            'child2' => ['x' => 2],
+        ],
+        'parent2' => [
+            'child1' => ['x' => 3],
+            '$' => ['x' => 4],
+        ],
+    ],
+]);
+
+echo "Wildcard path declared before explicit path\n";
+$document = $bson->toPHP(['fieldPaths' => [
+    'object.$.child1' => 'array',
+    'object.parent1.child1' => 'bson',
+    'object.parent1.$' => 'object',
+]]);
+var_dump(is_array($document->object->parent1->child1));
+var_dump($document->object->parent1->child2 instanceof stdClass);
+var_dump(is_array($document->object->parent2->child1));
+var_dump($document->object->parent2->{'$'} instanceof stdClass);
+
+echo "\nExplicit path declared before wildcard path\n";
+$document = $bson->toPHP(['document' => 'array', 'fieldPaths' => [
+    'object.parent1.child1' => 'bson',
+    'object.$.child1' => 'object',
+    'object.$' => 'object',
+]]);
+var_dump($document['object']['parent1'] instanceof stdClass);
+var_dump($document['object']['parent1']->child1 instanceof MongoDB\BSON\Document);
+var_dump(is_array($document['object']['parent1']->child2));
+var_dump($document['object']['parent2']->child1 instanceof stdClass);
+var_dump(is_array($document['object']['parent2']->{'$'}));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Wildcard path declared before explicit path
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+
+Explicit path declared before wildcard path
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+===DONE===
@@ -0,0 +1,80 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Reusing the same type map across calls
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php if (!function_exists('opcache_get_status') || !opcache_get_status(false)) exit('skip OPcache is not enabled'); ?>
+--INI--
+opcache.enable=1
+opcache.enable_cli=1
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class MyDocument implements MongoDB\BSON\Unserializable
+{
+    public $data;
+
+    public function bsonUnserialize(array $data): void
+    {
+        $this->data = $data;
+    }
+}
+
+$bson = MongoDB\BSON\Document::fromPHP([
+    'a' => ['b' => ['c' => 1]],
+    'd' => [1, 2, 3],
+]);
+
+function decode(MongoDB\BSON\Document $bson)
+{
+    // Array literals are immutable when cached by OPcache
+    return $bson->toPHP(['root' => 'array', 'fieldPaths' => ['a' => 'MyDocument', 'a.b' => 'bson', 'd' => 'object']]);
+}
+
+for ($i = 0; $i < 3; $i++) {
+    $document = decode($bson);
+    var_dump($document['a'] instanceof MyDocument);
+    var_dump($document['a']->data['b'] instanceof MongoDB\BSON\Document);
+    var_dump($document['d'] instanceof stdClass);
+}
+
+// Invalid type maps are not cached
+function decodeInvalid(MongoDB\BSON\Document $bson)
+{
+    return $bson->toPHP(['fieldPaths' => ['a' => 'MissingClass']]);
+}
+
+for ($i = 0; $i < 2; $i++) {
+    echo throws(function() use ($bson) {
+        decodeInvalid($bson);
+    }, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n";
+}
+
+// Type maps constructed at runtime must not be confused with cached ones
+$typeMap = ['root' => 'array'];
+$typeMap['fieldPaths'] = ['a' => 'array'];
+$document = $bson->toPHP($typeMap);
+var_dump(is_array($document['a']));
+var_dump($document['a']['b'] instanceof stdClass);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Class MissingClass does not exist
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Class MissingClass does not exist
+bool(true)
+bool(true)
+===DONE===
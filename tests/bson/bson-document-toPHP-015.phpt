@@ -0,0 +1,54 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Decoding keys shared across documents
+--FILE--
+<?php
+
+$documents = [];
+for ($i = 0; $i < 3; $i++) {
+    $documents[] = MongoDB\BSON\Document::fromPHP(['name' => 'doc' . $i, 'nested' => ['name' => $i]])->toPHP(['root' => 'array', 'document' => 'array']);
+}
+var_dump($documents[2]);
+
+echo "\nNumeric keys are stored as integers\n";
+var_dump(MongoDB\BSON\Document::fromJSON('{ "0": "a", "01": "b", "-1": "c" }')->toPHP(['root' => 'array']));
+
+echo "\nDuplicate keys are overwritten\n";
+var_dump(MongoDB\BSON\Document::fromJSON('{ "x": 1, "x": 2 }')->toPHP());
+
+echo "\nLong keys\n";
+$key = str_repeat('k', 100);
+var_dump(array_keys(MongoDB\BSON\Document::fromPHP([$key => 1])->toPHP(['root' => 'array']))[0] === $key);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+array(2) {
+  ["name"]=>
+  string(4) "doc2"
+  ["nested"]=>
+  array(1) {
+    ["name"]=>
+    int(2)
+  }
+}
+
+Numeric keys are stored as integers
+array(3) {
+  [0]=>
+  string(1) "a"
+  ["01"]=>
+  string(1) "b"
+  [-1]=>
+  string(1) "c"
+}
+
+Duplicate keys are overwritten
+object(stdClass)#%d (%d) {
+  ["x"]=>
+  int(2)
+}
+
+Long keys
+bool(true)
+===DONE===
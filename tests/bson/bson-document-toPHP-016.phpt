@@ -0,0 +1,56 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Persistable classes are resolved once and missing classes are looked up again
+--FILE--
+<?php
+
+class MyPersistable implements MongoDB\BSON\Persistable
+{
+    public $id;
+
+    public function __construct($id)
+    {
+        $this->id = $id;
+    }
+
+    public function bsonSerialize(): array
+    {
+        return ['id' => $this->id];
+    }
+
+    public function bsonUnserialize(array $data): void
+    {
+        $this->id = $data['id'];
+    }
+}
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'items' => [new MyPersistable(1), new MyPersistable(2), new MyPersistable(3)],
+]);
+
+foreach ($document->toPHP()->items as $item) {
+    printf("%s(%d)\n", get_class($item), $item->id);
+}
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'later' => ['__pclass' => new MongoDB\BSON\Binary('LaterPersistable', 0x80), 'id' => 4],
+]);
+
+echo get_class($document->toPHP()->later), "\n";
+
+if (true) {
+    class LaterPersistable extends MyPersistable {}
+}
+
+$later = $document->toPHP()->later;
+printf("%s(%d)\n", get_class($later), $later->id);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+MyPersistable(1)
+MyPersistable(2)
+MyPersistable(3)
+stdClass
+LaterPersistable(4)
+===DONE===
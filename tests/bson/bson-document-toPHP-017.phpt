@@ -0,0 +1,111 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Hydratable classes are initialized from the document's fields
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class Address implements MongoDB\BSON\Hydratable
+{
+    public string $city;
+    public string $country = 'unknown';
+}
+
+class Person implements MongoDB\BSON\Hydratable
+{
+    public readonly int $id;
+    public float $score;
+    public ?Address $address = null;
+    private array $tags = [];
+
+    public function getTags(): array
+    {
+        return $this->tags;
+    }
+}
+
+class PersistedPerson extends Person implements MongoDB\BSON\Persistable
+{
+    public function bsonSerialize(): array
+    {
+        return ['id' => $this->id, 'score' => $this->score];
+    }
+
+    public function bsonUnserialize(array $data): void
+    {
+        echo "bsonUnserialize() should not be called\n";
+    }
+}
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'id' => 1,
+    'score' => 5,
+    'address' => ['city' => 'Berlin'],
+    'tags' => ['a', 'b'],
+]);
+
+$person = $document->toPHP(['root' => Person::class, 'fieldPaths' => ['address' => Address::class, 'tags' => 'array']]);
+var_dump($person, $person->getTags());
+
+echo throws(function() use ($person) {
+    $person->id = 2;
+}, Error::class), "\n";
+
+$document = MongoDB\BSON\Document::fromPHP([
+    '__pclass' => new MongoDB\BSON\Binary(PersistedPerson::class, MongoDB\BSON\Binary::TYPE_USER_DEFINED),
+    'id' => 3,
+    'score' => 1.5,
+]);
+
+var_dump($document->toPHP());
+
+echo throws(function() {
+    MongoDB\BSON\Document::fromPHP(['id' => 'foo'])->toPHP(['root' => Person::class]);
+}, TypeError::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+object(Person)#%d (4) {
+  ["id"]=>
+  int(1)
+  ["score"]=>
+  float(5)
+  ["address"]=>
+  object(Address)#%d (2) {
+    ["city"]=>
+    string(6) "Berlin"
+    ["country"]=>
+    string(7) "unknown"
+  }
+  ["tags":"Person":private]=>
+  array(2) {
+    [0]=>
+    string(1) "a"
+    [1]=>
+    string(1) "b"
+  }
+}
+array(2) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  string(1) "b"
+}
+OK: Got Error
+Cannot modify readonly property Person::$id
+object(PersistedPerson)#%d (4) {
+  ["id"]=>
+  int(3)
+  ["score"]=>
+  float(1.5)
+  ["address"]=>
+  NULL
+  ["tags":"Person":private]=>
+  array(0) {
+  }
+}
+OK: Got TypeError
+Cannot assign string to property Person::$id of type int
+===DONE===
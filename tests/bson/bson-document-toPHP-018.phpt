@@ -0,0 +1,90 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Type map coerces scalar BSON types
+--FILE--
+<?php
+
+$document = MongoDB\BSON\Document::fromPHP([
+    '_id' => new MongoDB\BSON\ObjectId('56315a7c6118fd1b920270b1'),
+    'createdAt' => new MongoDB\BSON\UTCDateTime(1416445411987),
+    'price' => new MongoDB\BSON\Decimal128('1234.5678'),
+    'count' => new MongoDB\BSON\Int64(123),
+    'owner' => [
+        '_id' => new MongoDB\BSON\ObjectId('56315a7c6118fd1b920270b2'),
+        'since' => new MongoDB\BSON\UTCDateTime(1416445411987),
+    ],
+]);
+
+echo "Default coercions\n";
+var_dump($document->toPHP(['root' => 'array', 'document' => 'array', 'types' => [
+    'objectId' => 'string',
+    'utcDateTime' => 'int',
+    'decimal128' => 'string',
+    'int64' => 'int',
+]]));
+
+echo "\nCoercions for field paths\n";
+$result = $document->toPHP([
+    'fieldPaths' => ['owner' => 'array'],
+    'types' => [
+        'objectId' => 'string',
+        'fieldPaths' => [
+            '_id' => 'binary',
+            'owner.since' => 'DateTimeImmutable',
+            'price' => 'string',
+        ],
+    ],
+]);
+var_dump(bin2hex($result->_id));
+var_dump($result->createdAt instanceof MongoDB\BSON\UTCDateTime);
+var_dump($result->price);
+var_dump($result->count instanceof MongoDB\BSON\Int64);
+var_dump($result->owner['_id']);
+var_dump($result->owner['since']->format('Y-m-d\TH:i:s.vP'));
+
+echo "\nClass names in fieldPaths are not coercions\n";
+class Binary implements MongoDB\BSON\Unserializable
+{
+    public function bsonUnserialize(array $data): void
+    {
+        echo "Binary::bsonUnserialize() called\n";
+    }
+}
+
+$result = $document->toPHP(['fieldPaths' => ['owner' => 'Binary']]);
+var_dump($result->owner instanceof Binary);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Default coercions
+array(5) {
+  ["_id"]=>
+  string(24) "56315a7c6118fd1b920270b1"
+  ["createdAt"]=>
+  int(1416445411987)
+  ["price"]=>
+  string(9) "1234.5678"
+  ["count"]=>
+  int(123)
+  ["owner"]=>
+  array(2) {
+    ["_id"]=>
+    string(24) "56315a7c6118fd1b920270b2"
+    ["since"]=>
+    int(1416445411987)
+  }
+}
+
+Coercions for field paths
+string(24) "56315a7c6118fd1b920270b1"
+bool(true)
+string(9) "1234.5678"
+bool(true)
+string(24) "56315a7c6118fd1b920270b2"
+string(29) "2014-11-20T01:03:31.987+00:00"
+
+Class names in fieldPaths are not coercions
+Binary::bsonUnserialize() called
+bool(true)
+===DONE===
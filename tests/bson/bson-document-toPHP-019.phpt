@@ -0,0 +1,40 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Hydratable classes assign hooked and virtual properties through their hooks
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_php_version('<', '8.4.0'); ?>
+--FILE--
+<?php
+
+class Person implements MongoDB\BSON\Hydratable
+{
+    public string $name {
+        set => strtoupper($value);
+    }
+
+    public string $nickname {
+        set {
+            $this->name = $value;
+        }
+    }
+}
+
+$document = MongoDB\BSON\Document::fromPHP(['name' => 'alice']);
+var_dump($document->toPHP(['root' => Person::class]));
+
+$document = MongoDB\BSON\Document::fromPHP(['nickname' => 'bob']);
+var_dump($document->toPHP(['root' => Person::class]));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+object(Person)#%d (1) {
+  ["name"]=>
+  string(5) "ALICE"
+}
+object(Person)#%d (1) {
+  ["name"]=>
+  string(3) "BOB"
+}
+===DONE===
@@ -0,0 +1,100 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Type map scalar coercions must be valid
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$typeMaps = [
+    ['types' => 'string'],
+    ['types' => ['string']],
+    ['types' => ['timestamp' => 'int']],
+    ['types' => ['objectId' => 'int']],
+    ['types' => ['utcDateTime' => 'string']],
+    ['types' => ['decimal128' => 'binary']],
+    ['types' => ['int64' => 'DateTimeImmutable']],
+    ['types' => ['int64' => 1]],
+    ['types' => ['fieldPaths' => 'string']],
+    ['types' => ['fieldPaths' => ['string']]],
+    ['types' => ['fieldPaths' => ['x' => 'array']]],
+    ['types' => ['fieldPaths' => ['x' => 1]]],
+    ['fieldPaths' => ['x' => 'array'], 'types' => ['fieldPaths' => ['x' => 'string']]],
+    ['fieldPaths' => ['x' => 'binary']],
+    ['root' => 'string'],
+];
+
+$document = MongoDB\BSON\Document::fromPHP([]);
+
+foreach ($typeMaps as $typeMap) {
+    printf("Test typeMap: %s\n", json_encode($typeMap));
+
+    echo throws(function() use ($document, $typeMap) {
+        $document->toPHP($typeMap);
+    }, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Test typeMap: {"types":"string"}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The 'types' element is not an array
+
+Test typeMap: {"types":["string"]}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The 'types' element is not an associative array
+
+Test typeMap: {"types":{"timestamp":"int"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The 'types' element does not support BSON type 'timestamp'
+
+Test typeMap: {"types":{"objectId":"int"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+BSON type 'objectId' cannot be decoded as 'int'
+
+Test typeMap: {"types":{"utcDateTime":"string"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+BSON type 'utcDateTime' cannot be decoded as 'string'
+
+Test typeMap: {"types":{"decimal128":"binary"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+BSON type 'decimal128' cannot be decoded as 'binary'
+
+Test typeMap: {"types":{"int64":"DateTimeImmutable"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+BSON type 'int64' cannot be decoded as 'DateTimeImmutable'
+
+Test typeMap: {"types":{"int64":1}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected 'types' element 'int64' to be a string, int given
+
+Test typeMap: {"types":{"fieldPaths":"string"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The 'types.fieldPaths' element is not an array
+
+Test typeMap: {"types":{"fieldPaths":["string"]}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The 'types.fieldPaths' element is not an associative array
+
+Test typeMap: {"types":{"fieldPaths":{"x":"array"}}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected 'types.fieldPaths' element 'x' to be 'string', 'binary', 'int', or 'DateTimeImmutable'
+
+Test typeMap: {"types":{"fieldPaths":{"x":1}}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected 'types.fieldPaths' element 'x' to be 'string', 'binary', 'int', or 'DateTimeImmutable'
+
+Test typeMap: {"fieldPaths":{"x":"array"},"types":{"fieldPaths":{"x":"string"}}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+The field path 'x' may not be specified in both the 'fieldPaths' and 'types' elements
+
+Test typeMap: {"fieldPaths":{"x":"binary"}}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Class binary does not exist
+
+Test typeMap: {"root":"string"}
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Class string does not exist
+
+===DONE===
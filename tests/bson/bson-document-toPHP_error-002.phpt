@@ -0,0 +1,39 @@
+--TEST--
+MongoDB\BSON\Document::toPHP(): Decoding fails if a Hydratable class cannot be initialized
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class Address implements MongoDB\BSON\Hydratable
+{
+    public string $city;
+}
+
+$document = MongoDB\BSON\Document::fromPHP([
+    'name' => 'alice',
+    'address' => ['city' => ['Berlin']],
+]);
+
+$result = 'unchanged';
+
+echo throws(function() use ($document, &$result) {
+    $result = $document->toPHP(['fieldPaths' => ['address' => Address::class]]);
+}, TypeError::class), "\n";
+
+var_dump($result);
+
+echo throws(function() use ($document) {
+    $document->get('address')->toPHP(['root' => Address::class]);
+}, TypeError::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+OK: Got TypeError
+Cannot assign array to property Address::$city of type string
+string(9) "unchanged"
+OK: Got TypeError
+Cannot assign array to property Address::$city of type string
+===DONE===
@@ -0,0 +1,34 @@
+--TEST--
+MongoDB\BSON\fromPHP(): Encoding documents larger than the initial buffer
+--FILE--
+<?php
+
+foreach ([0, 100, 1000, 100000] as $size) {
+    $document = ['x' => str_repeat('a', $size), 'y' => range(1, $size / 100)];
+    $bson = MongoDB\BSON\fromPHP($document);
+
+    var_dump(strlen($bson) === unpack('V', $bson)[1]);
+    var_dump(MongoDB\BSON\Document::fromBSON($bson)->toPHP(['root' => 'array', 'document' => 'array']) === $document);
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+
+Deprecated: Function MongoDB\BSON\fromPHP() is deprecated in %s
+bool(true)
+bool(true)
+
+Deprecated: Function MongoDB\BSON\fromPHP() is deprecated in %s
+bool(true)
+bool(true)
+
+Deprecated: Function MongoDB\BSON\fromPHP() is deprecated in %s
+bool(true)
+bool(true)
+
+Deprecated: Function MongoDB\BSON\fromPHP() is deprecated in %s
+bool(true)
+bool(true)
+===DONE===
@@ -0,0 +1,32 @@
+--TEST--
+MongoDB\BSON\ObjectId comparisons are independent of the hex string's case
+--FILE--
+<?php
+
+$ids = [
+    new MongoDB\BSON\ObjectId('ff0000000000000000000000'),
+    new MongoDB\BSON\ObjectId('0A0000000000000000000000'),
+    new MongoDB\BSON\ObjectId('a00000000000000000000000'),
+    new MongoDB\BSON\ObjectId('000000000000000000000001'),
+];
+
+usort($ids, fn($a, $b) => $a <=> $b);
+
+foreach ($ids as $id) {
+    echo $id, "\n";
+}
+
+var_dump(new MongoDB\BSON\ObjectId('53E2A1C40640FD72175D4603') == new MongoDB\BSON\ObjectId('53e2a1c40640fd72175d4603'));
+var_dump(new MongoDB\BSON\ObjectId('53E2A1C40640FD72175D4603') <=> new MongoDB\BSON\ObjectId('53e2a1c40640fd72175d4604'));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+000000000000000000000001
+0a0000000000000000000000
+a00000000000000000000000
+ff0000000000000000000000
+bool(true)
+int(-1)
+===DONE===
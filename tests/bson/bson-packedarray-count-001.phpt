@@ -0,0 +1,25 @@
+--TEST--
+MongoDB\BSON\PackedArray::count() returns the number of elements
+--FILE--
+<?php
+
+var_dump(MongoDB\BSON\PackedArray::fromPHP([])->count());
+
+$array = MongoDB\BSON\PackedArray::fromPHP([0, 'foo', ['bar' => 'baz'], [1, 2, 3]]);
+var_dump($array instanceof Countable);
+var_dump($array->count());
+var_dump(count($array));
+
+$clone = clone $array;
+var_dump(count($clone));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+int(0)
+bool(true)
+int(4)
+int(4)
+int(4)
+===DONE===
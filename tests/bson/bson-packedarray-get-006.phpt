@@ -0,0 +1,31 @@
+--TEST--
+MongoDB\BSON\PackedArray::get() random access
+--FILE--
+<?php
+
+$array = MongoDB\BSON\PackedArray::fromPHP(range(0, 9999));
+
+$sum = 0;
+for ($i = 9999; $i >= 0; $i -= 100) {
+    $sum += $array->get($i);
+}
+var_dump($sum);
+var_dump($array[5000]);
+var_dump($array->has(9999));
+var_dump($array->has(10000));
+var_dump($array->has(-1));
+var_dump(isset($array[-1]));
+var_dump($array[10000] ?? null);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+int(504900)
+int(5000)
+bool(true)
+bool(false)
+bool(false)
+bool(false)
+NULL
+===DONE===
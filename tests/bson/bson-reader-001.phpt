@@ -0,0 +1,48 @@
+--TEST--
+MongoDB\BSON\Reader reads consecutive documents from a stream
+--FILE--
+<?php
+
+$stream = fopen('php://temp', 'w+');
+for ($i = 0; $i < 3; $i++) {
+    fwrite($stream, (string) MongoDB\BSON\Document::fromPHP(['_id' => $i, 'x' => str_repeat('a', $i)]));
+}
+
+rewind($stream);
+$documents = [];
+foreach (new MongoDB\BSON\Reader($stream) as $key => $document) {
+    var_dump($key, $document instanceof MongoDB\BSON\Document);
+    // Retained documents must remain valid after the reader advances
+    $documents[] = $document;
+}
+
+foreach ($documents as $document) {
+    echo $document->toRelaxedExtendedJSON(), "\n";
+}
+
+rewind($stream);
+foreach (new MongoDB\BSON\Reader($stream, ['root' => 'array']) as $document) {
+    var_dump($document);
+    break;
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+int(0)
+bool(true)
+int(1)
+bool(true)
+int(2)
+bool(true)
+{ "_id" : 0, "x" : "" }
+{ "_id" : 1, "x" : "a" }
+{ "_id" : 2, "x" : "aa" }
+array(2) {
+  ["_id"]=>
+  int(0)
+  ["x"]=>
+  string(0) ""
+}
+===DONE===
@@ -0,0 +1,39 @@
+--TEST--
+MongoDB\BSON\Reader releases documents that are not retained
+--FILE--
+<?php
+
+$stream = fopen('php://temp', 'w+');
+for ($i = 0; $i < 3; $i++) {
+    fwrite($stream, (string) MongoDB\BSON\Document::fromPHP(['_id' => $i]));
+}
+
+rewind($stream);
+$reader = new MongoDB\BSON\Reader($stream);
+
+// Documents are released when the reader advances
+foreach ($reader as $document) {
+    var_dump($document->get('_id'));
+    unset($document);
+}
+
+rewind($stream);
+$reader = new MongoDB\BSON\Reader($stream);
+$reader->rewind();
+$document = $reader->current();
+
+// The current document outlives the reader and its stream
+unset($reader);
+fclose($stream);
+
+echo $document->toRelaxedExtendedJSON(), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+int(0)
+int(1)
+int(2)
+{ "_id" : 0 }
+===DONE===
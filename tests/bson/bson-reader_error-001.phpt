@@ -0,0 +1,46 @@
+--TEST--
+MongoDB\BSON\Reader errors
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$bson = (string) MongoDB\BSON\Document::fromPHP(['x' => 1]);
+
+echo "Truncated document at end of stream\n";
+$stream = fopen('php://temp', 'w+');
+fwrite($stream, $bson . substr($bson, 0, 5));
+rewind($stream);
+
+echo throws(function() use ($stream) {
+    foreach (new MongoDB\BSON\Reader($stream) as $key => $document) {
+        echo $key, ': ', $document->toRelaxedExtendedJSON(), "\n";
+    }
+}, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+
+echo "\nRewinding after starting iteration\n";
+$stream = fopen('php://temp', 'w+');
+fwrite($stream, $bson . $bson);
+rewind($stream);
+
+$reader = new MongoDB\BSON\Reader($stream);
+$reader->rewind();
+$reader->rewind();
+$reader->next();
+
+echo throws(function() use ($reader) {
+    $reader->rewind();
+}, MongoDB\Driver\Exception\LogicException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Truncated document at end of stream
+0: { "x" : 1 }
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+Could not read BSON document from stream at offset 12
+Rewinding after starting iteration
+OK: Got MongoDB\Driver\Exception\LogicException
+Readers cannot rewind after starting iteration
+===DONE===
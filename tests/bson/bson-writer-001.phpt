@@ -0,0 +1,62 @@
+--TEST--
+MongoDB\BSON\Writer writes consecutive documents to a stream
+--FILE--
+<?php
+
+$documents = [
+    ['_id' => 1, 'x' => 'foo'],
+    (object) ['_id' => 2, 'x' => [1, 2, 3]],
+    MongoDB\BSON\Document::fromPHP(['_id' => 3]),
+];
+
+$expected = '';
+foreach ($documents as $document) {
+    $expected .= MongoDB\BSON\Document::fromPHP($document);
+}
+
+$stream = fopen('php://temp', 'w+');
+$writer = new MongoDB\BSON\Writer($stream, 32);
+
+$writer->write($documents[0]);
+echo "After first write: ", ftell($stream), "\n";
+
+$writer->write($documents[1]);
+echo "After second write: ", ftell($stream), "\n";
+
+$writer->write($documents[2]);
+echo "After third write: ", ftell($stream), "\n";
+
+$writer->flush();
+echo "After flush: ", ftell($stream), "\n";
+
+rewind($stream);
+var_dump(stream_get_contents($stream) === $expected);
+
+echo "\nBuffered documents are written when the writer is destroyed\n";
+$stream = fopen('php://temp', 'w+');
+$writer = new MongoDB\BSON\Writer($stream);
+foreach ($documents as $document) {
+    $writer->write($document);
+}
+unset($writer);
+
+rewind($stream);
+foreach (new MongoDB\BSON\Reader($stream) as $document) {
+    echo $document->toRelaxedExtendedJSON(), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+After first write: 0
+After second write: 68
+After third write: 68
+After flush: 82
+bool(true)
+
+Buffered documents are written when the writer is destroyed
+{ "_id" : 1, "x" : "foo" }
+{ "_id" : 2, "x" : [ 1, 2, 3 ] }
+{ "_id" : 3 }
+===DONE===
@@ -0,0 +1,41 @@
+--TEST--
+MongoDB\BSON\Writer errors
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+echo throws(function() {
+    new MongoDB\BSON\Writer(fopen('php://temp', 'w+'), 0);
+}, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n";
+
+echo "\nDocuments that cannot be encoded are discarded\n";
+$stream = fopen('php://temp', 'w+');
+$writer = new MongoDB\BSON\Writer($stream);
+$writer->write(['x' => 1]);
+
+echo throws(function() use ($writer) {
+    $writer->write(['x' => 2, "\0y" => 3]);
+}, MongoDB\Driver\Exception\UnexpectedValueException::class), "\n";
+
+$writer->write(['x' => 3]);
+$writer->flush();
+
+rewind($stream);
+foreach (new MongoDB\BSON\Reader($stream) as $document) {
+    echo $document->toRelaxedExtendedJSON(), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected bufferSize to be a positive 32-bit integer, 0 given
+
+Documents that cannot be encoded are discarded
+OK: Got MongoDB\Driver\Exception\UnexpectedValueException
+BSON keys cannot contain null bytes. Unexpected null byte after "".
+{ "x" : 1 }
+{ "x" : 3 }
+===DONE===
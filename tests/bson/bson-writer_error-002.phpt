@@ -0,0 +1,76 @@
+--TEST--
+MongoDB\BSON\Writer retains documents that could not be written to the stream
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+class LimitedStream
+{
+    public static $capacity = 0;
+    public static $data = '';
+    public $context;
+
+    public function stream_open($path, $mode, $options, &$openedPath): bool
+    {
+        return true;
+    }
+
+    public function stream_write(string $data): int
+    {
+        $length = min(strlen($data), self::$capacity);
+        self::$capacity -= $length;
+        self::$data .= substr($data, 0, $length);
+
+        return $length;
+    }
+}
+
+stream_wrapper_register('limited', LimitedStream::class);
+
+$writer = new MongoDB\BSON\Writer(fopen('limited://', 'w'));
+for ($i = 0; $i < 3; $i++) {
+    $writer->write(['x' => $i]);
+}
+
+echo "Partial write\n";
+LimitedStream::$capacity = 20;
+echo throws(function() use ($writer) {
+    $writer->flush();
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+echo "\nFailed write\n";
+echo throws(function() use ($writer) {
+    $writer->flush();
+}, MongoDB\Driver\Exception\RuntimeException::class), "\n";
+
+echo "\nRemaining bytes are written by the next flush\n";
+LimitedStream::$capacity = 1024;
+$writer->write(['x' => 3]);
+$writer->flush();
+
+$stream = fopen('php://memory', 'w+');
+fwrite($stream, LimitedStream::$data);
+rewind($stream);
+foreach (new MongoDB\BSON\Reader($stream) as $document) {
+    echo $document->toRelaxedExtendedJSON(), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Partial write
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not write 36 bytes to stream: only 20 bytes were written
+
+Failed write
+OK: Got MongoDB\Driver\Exception\RuntimeException
+Could not write 16 bytes to stream
+
+Remaining bytes are written by the next flush
+{ "x" : 0 }
+{ "x" : 1 }
+{ "x" : 2 }
+{ "x" : 3 }
+===DONE===
@@ -0,0 +1,56 @@
+--TEST--
+MongoDB\Driver\BulkWrite::insertMany() adds documents from arrays and iterators
+--FILE--
+<?php
+
+$bulk = new MongoDB\Driver\BulkWrite();
+
+$ids = $bulk->insertMany([
+    ['x' => 1],
+    ['_id' => new MongoDB\BSON\ObjectId('590b72d606e9660190656a55')],
+    (object) ['_id' => ['foo' => 1]],
+    ['_id' => 2],
+]);
+
+var_dump(count($ids));
+var_dump($ids[0] instanceof MongoDB\BSON\ObjectId);
+var_dump((string) $ids[1]);
+var_dump($ids[2]);
+var_dump($ids[3]);
+var_dump(count($bulk));
+
+function generateDocuments()
+{
+    for ($i = 0; $i < 3; $i++) {
+        yield ['_id' => $i];
+    }
+}
+
+var_dump($bulk->insertMany(generateDocuments()));
+var_dump($bulk->insertMany(new ArrayIterator([['x' => 1], ['x' => 2]]), false));
+var_dump(count($bulk));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+int(4)
+bool(true)
+string(24) "590b72d606e9660190656a55"
+object(stdClass)#%d (%d) {
+  ["foo"]=>
+  int(1)
+}
+int(2)
+int(4)
+array(3) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(1)
+  [2]=>
+  int(2)
+}
+NULL
+int(9)
+===DONE===
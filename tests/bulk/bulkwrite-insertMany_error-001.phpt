@@ -0,0 +1,32 @@
+--TEST--
+MongoDB\Driver\BulkWrite::insertMany() with invalid documents
+--FILE--
+<?php
+
+require_once __DIR__ . '/../utils/basic.inc';
+
+$bulk = new MongoDB\Driver\BulkWrite;
+
+echo throws(function() use ($bulk) {
+    $bulk->insertMany([['x' => 1], 'foo']);
+}, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n\n";
+
+echo throws(function() use ($bulk) {
+    $bulk->insertMany(new ArrayIterator([['x' => 1], ['' => 1]]));
+}, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n\n";
+
+/* Documents preceding an invalid document remain in the bulk */
+var_dump(count($bulk));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected document to be array or object, string given
+
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+invalid document for insert: empty key
+
+int(2)
+===DONE===
@@ -0,0 +1,62 @@
+--TEST--
+MongoDB\Driver\Cursor::nextBatch()
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+$manager = create_test_manager();
+
+$bulk = new MongoDB\Driver\BulkWrite();
+for ($i = 0; $i < 5; $i++) {
+    $bulk->insert(['_id' => $i]);
+}
+$manager->executeBulkWrite(NS, $bulk);
+
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+
+while ($batch = $cursor->nextBatch()) {
+    echo json_encode($batch), "\n";
+}
+
+var_dump($cursor->valid());
+var_dump($cursor->isDead());
+
+echo "\nRaw batches after partial iteration:\n";
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+
+$cursor->rewind();
+$cursor->next();
+var_dump($cursor->current());
+
+do {
+    $batch = $cursor->nextBatch(true);
+    var_dump($batch instanceof MongoDB\BSON\PackedArray);
+    echo $batch->toRelaxedExtendedJSON(), "\n";
+} while (count($batch->toPHP()) > 0);
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECTF--
+[{"_id":0},{"_id":1}]
+[{"_id":2},{"_id":3}]
+[{"_id":4}]
+bool(false)
+bool(true)
+
+Raw batches after partial iteration:
+object(stdClass)#%d (%d) {
+  ["_id"]=>
+  int(1)
+}
+bool(true)
+[ { "_id" : 1 }, { "_id" : 2 } ]
+bool(true)
+[ { "_id" : 3 }, { "_id" : 4 } ]
+bool(true)
+[ ]
+===DONE===
@@ -0,0 +1,66 @@
+--TEST--
+MongoDB\Driver\Cursor::nextBatch() does not decode results in raw mode
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+class MyDocument implements MongoDB\BSON\Unserializable
+{
+    public $id;
+
+    public function bsonUnserialize(array $data): void
+    {
+        echo "Decoding document ", $data['_id'], "\n";
+        $this->id = $data['_id'];
+    }
+}
+
+$manager = create_test_manager();
+
+$bulk = new MongoDB\Driver\BulkWrite();
+for ($i = 0; $i < 5; $i++) {
+    $bulk->insert(['_id' => $i]);
+}
+$manager->executeBulkWrite(NS, $bulk);
+
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+$cursor->setTypeMap(['root' => MyDocument::class]);
+
+echo $cursor->nextBatch(true)->toRelaxedExtendedJSON(), "\n";
+
+// The next result is only decoded once it is accessed
+var_dump($cursor->valid());
+var_dump($cursor->key());
+var_dump($cursor->current()->id);
+
+echo $cursor->nextBatch(true)->toRelaxedExtendedJSON(), "\n";
+
+// A type map set after a raw batch applies to the next result
+$cursor->setTypeMap(['root' => 'array']);
+var_dump($cursor->nextBatch());
+
+var_dump($cursor->valid());
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+[ { "_id" : 0 }, { "_id" : 1 } ]
+bool(true)
+int(2)
+Decoding document 2
+int(2)
+[ { "_id" : 2 }, { "_id" : 3 } ]
+array(1) {
+  [0]=>
+  array(1) {
+    ["_id"]=>
+    int(4)
+  }
+}
+bool(false)
+===DONE===
@@ -0,0 +1,71 @@
+--TEST--
+MongoDB\Driver\Cursor::setAdaptiveBatchSize() adjusts the batch size of getMore commands
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+class CommandLogger implements MongoDB\Driver\Monitoring\CommandSubscriber
+{
+    public function commandStarted(MongoDB\Driver\Monitoring\CommandStartedEvent $event): void
+    {
+        $command = $event->getCommand();
+        $commandName = $event->getCommandName();
+
+        if ($commandName === 'find' || $commandName === 'getMore') {
+            printf("Executes %s with batchSize: %d\n", $commandName, $command->batchSize);
+        }
+    }
+
+    public function commandSucceeded(MongoDB\Driver\Monitoring\CommandSucceededEvent $event): void
+    {
+    }
+
+    public function commandFailed(MongoDB\Driver\Monitoring\CommandFailedEvent $event): void
+    {
+    }
+}
+
+$manager = create_test_manager();
+
+/* Each document is 1022 bytes of BSON */
+$bulk = new MongoDB\Driver\BulkWrite();
+for ($i = 0; $i < 13; $i++) {
+    $bulk->insert(['_id' => $i, 'x' => str_repeat('a', 1000)]);
+}
+$manager->executeBulkWrite(NS, $bulk);
+
+MongoDB\Driver\Monitoring\addSubscriber(new CommandLogger);
+
+echo "Target of 5500 bytes:\n";
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+$cursor->setAdaptiveBatchSize(5500);
+printf("Iterated %d documents\n", count($cursor->toArray()));
+
+echo "\nTarget of 5500 bytes with a maximum batch size of 3:\n";
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+$cursor->setAdaptiveBatchSize(5500, 1, 3);
+printf("Iterated %d documents\n", count($cursor->toArray()));
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+Target of 5500 bytes:
+Executes find with batchSize: 2
+Executes getMore with batchSize: 5
+Executes getMore with batchSize: 5
+Executes getMore with batchSize: 5
+Iterated 13 documents
+
+Target of 5500 bytes with a maximum batch size of 3:
+Executes find with batchSize: 2
+Executes getMore with batchSize: 3
+Executes getMore with batchSize: 3
+Executes getMore with batchSize: 3
+Executes getMore with batchSize: 3
+Iterated 13 documents
+===DONE===
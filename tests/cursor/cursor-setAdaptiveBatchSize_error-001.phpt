@@ -0,0 +1,36 @@
+--TEST--
+MongoDB\Driver\Cursor::setAdaptiveBatchSize() requires valid bounds
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+$manager = create_test_manager();
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([]));
+
+$tests = [
+    [0],
+    [1024, 0],
+    [1024, 10, 5],
+];
+
+foreach ($tests as $args) {
+    echo throws(function() use ($cursor, $args) {
+        $cursor->setAdaptiveBatchSize(...$args);
+    }, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected targetBatchBytes to be a positive 32-bit integer, 0 given
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected minBatchSize to be a positive 32-bit integer, 0 given
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected maxBatchSize to be a 32-bit integer greater than or equal to minBatchSize, 5 given
+===DONE===
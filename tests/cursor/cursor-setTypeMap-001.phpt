@@ -0,0 +1,58 @@
+--TEST--
+MongoDB\Driver\Cursor::setTypeMap(): Documents for the "bson" root type remain valid after the cursor advances
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+$manager = create_test_manager();
+
+$bulk = new MongoDB\Driver\BulkWrite();
+for ($i = 0; $i < 5; $i++) {
+    $bulk->insert(['_id' => $i, 'x' => ['y' => str_repeat('a', $i)]]);
+}
+$manager->executeBulkWrite(NS, $bulk);
+
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+$cursor->setTypeMap(['root' => 'bson']);
+
+$documents = [];
+
+foreach ($cursor as $document) {
+    var_dump($document instanceof MongoDB\BSON\Document);
+    $documents[] = $document;
+}
+
+// Keep one document and its iterator alive after the cursor is destroyed
+$last = $documents[4];
+$iterator = $last->getIterator();
+unset($cursor);
+
+foreach ($documents as $document) {
+    printf("%d: %s\n", $document->get('_id'), $document->get('x')->get('y'));
+}
+
+foreach ($iterator as $key => $value) {
+    echo $key, "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+0: 
+1: a
+2: aa
+3: aaa
+4: aaaa
+_id
+x
+===DONE===
@@ -0,0 +1,75 @@
+--TEST--
+MongoDB\Driver\Cursor::toColumns()
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+class MyDocument implements MongoDB\BSON\Unserializable
+{
+    public function bsonUnserialize(array $data): void
+    {
+        throw new Exception('bsonUnserialize() should not be called');
+    }
+}
+
+$manager = create_test_manager();
+
+$bulk = new MongoDB\Driver\BulkWrite();
+$bulk->insert(['_id' => 1, 'name' => 'a', 'stats' => ['views' => 10, 'tags' => ['x']]]);
+$bulk->insert(['_id' => 2, 'name' => 'b', 'stats' => ['views' => new MongoDB\BSON\Int64(20)]]);
+$bulk->insert(['_id' => 3, 'stats' => ['views' => 30.5]]);
+$manager->executeBulkWrite(NS, $bulk);
+
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+// Results are not decoded with the type map
+$cursor->setTypeMap(['root' => MyDocument::class]);
+$columns = $cursor->toColumns(['_id', 'name', 'stats.views', 'stats.tags']);
+
+var_dump($columns['_id'], $columns['name'], $columns['stats.views']);
+var_dump($columns['stats.tags'][0] instanceof MongoDB\BSON\PackedArray);
+var_dump($columns['stats.tags'][1], $columns['stats.tags'][2]);
+var_dump($cursor->valid());
+
+echo throws(function() use ($manager) {
+    $manager->executeQuery(NS, new MongoDB\Driver\Query([]))->toColumns(['name', 1]);
+}, MongoDB\Driver\Exception\InvalidArgumentException::class), "\n";
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+array(3) {
+  [0]=>
+  int(1)
+  [1]=>
+  int(2)
+  [2]=>
+  int(3)
+}
+array(3) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  string(1) "b"
+  [2]=>
+  NULL
+}
+array(3) {
+  [0]=>
+  int(10)
+  [1]=>
+  int(20)
+  [2]=>
+  float(30.5)
+}
+bool(true)
+NULL
+NULL
+bool(false)
+OK: Got MongoDB\Driver\Exception\InvalidArgumentException
+Expected field paths to be strings, int given
+===DONE===
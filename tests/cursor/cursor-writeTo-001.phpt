@@ -0,0 +1,79 @@
+--TEST--
+MongoDB\Driver\Cursor::writeTo()
+--SKIPIF--
+<?php require __DIR__ . "/../utils/basic-skipif.inc"; ?>
+<?php skip_if_not_live(); ?>
+<?php skip_if_not_clean(); ?>
+--FILE--
+<?php
+require_once __DIR__ . "/../utils/basic.inc";
+
+class MyDocument implements MongoDB\BSON\Unserializable
+{
+    public function bsonUnserialize(array $data): void
+    {
+        echo "bsonUnserialize() should not be called\n";
+    }
+}
+
+$manager = create_test_manager();
+
+$bulk = new MongoDB\Driver\BulkWrite();
+for ($i = 0; $i < 5; $i++) {
+    $bulk->insert(['_id' => $i, 'x' => new MongoDB\BSON\Int64(1 << 40)]);
+}
+$manager->executeBulkWrite(NS, $bulk);
+
+foreach (['relaxed-json', 'canonical-json'] as $format) {
+    echo $format, ":\n";
+    $cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+    // Results are written without being decoded with the type map
+    $cursor->setTypeMap(['root' => MyDocument::class]);
+    $stream = fopen('php://memory', 'w+');
+    var_dump($cursor->writeTo($stream, $format));
+    rewind($stream);
+    echo stream_get_contents($stream), "\n";
+}
+
+echo "bson after partial iteration:\n";
+$cursor = $manager->executeQuery(NS, new MongoDB\Driver\Query([], ['batchSize' => 2]));
+$cursor->rewind();
+$cursor->next();
+
+$stream = fopen('php://memory', 'w+');
+var_dump($cursor->writeTo($stream));
+var_dump($cursor->valid());
+rewind($stream);
+
+foreach (new MongoDB\BSON\Reader($stream) as $document) {
+    echo $document->toRelaxedExtendedJSON(), "\n";
+}
+
+?>
+===DONE===
+<?php exit(0); ?>
+--EXPECT--
+relaxed-json:
+int(5)
+{ "_id" : 0, "x" : 1099511627776 }
+{ "_id" : 1, "x" : 1099511627776 }
+{ "_id" : 2, "x" : 1099511627776 }
+{ "_id" : 3, "x" : 1099511627776 }
+{ "_id" : 4, "x" : 1099511627776 }
+
+canonical-json:
+int(5)
+{ "_id" : { "$numberInt" : "0" }, "x" : { "$numberLong" : "1099511627776" } }
+{ "_id" : { "$numberInt" : "1" }, "x" : { "$numberLong" : "1099511627776" } }
+{ "_id" : { "$numberInt" : "2" }, "x" : { "$numberLong" : "1099511627776" } }
+{ "_id" : { "$numberInt" : "3" }, "x" : { "$numberLong" : "1099511627776" } }
+{ "_id" : { "$numberInt" : "4" }, "x" : { "$numberLong" : "1099511627776" } }
+
+bson after partial iteration:
+int(4)
+bool(false)
+{ "_id" : 1, "x" : 1099511627776 }
+{ "_id" : 2, "x" : 1099511627776 }
+{ "_id" : 3, "x" : 1099511627776 }
+{ "_id" : 4, "x" : 1099511627776 }
+===DONE===